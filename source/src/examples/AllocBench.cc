@@ -0,0 +1,390 @@
+//                              -*- Mode: C++ -*-
+//
+// uC++ Version 6.1.0, Copyright (C) agent 2026
+//
+// AllocBench.cc -- Multi-processor allocator benchmarks.
+//
+// Author           : agent
+// Created On       : Sun Oct 18 05:27:27 2026
+// Last Modified By : agent
+// Last Modified On : Sun Oct 18 06:36:17 2026
+// Update Count     : 3
+//
+// This  library is free  software; you  can redistribute  it and/or  modify it
+// under the terms of the GNU Lesser General Public License as published by the
+// Free Software  Foundation; either  version 2.1 of  the License, or  (at your
+// option) any later version.
+//
+// This library is distributed in the  hope that it will be useful, but WITHOUT
+// ANY  WARRANTY;  without even  the  implied  warranty  of MERCHANTABILITY  or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+// for more details.
+//
+// You should  have received a  copy of the  GNU Lesser General  Public License
+// along  with this library.
+//
+
+// Each test runs its tasks on the given number of processors and prints one comma-separated line per measurement,
+// after a header line naming the fields. An operation is an allocation, a free or a realloc. RSS is the resident set
+// size after the test and the peak for the process so far, in kilobytes.
+//
+//   larson   : each task replaces random blocks in its array of blocks, and each generation of tasks takes over the
+//              arrays of the previous one, so blocks are freed by a different task than allocated them.
+//   prodcons : producers on one cluster allocate blocks and pass them in batches to consumers on another cluster, which
+//              free them, so blocks are allocated and freed on different processors.
+//   sweep    : each task allocates and frees batches of one size, for sizes from 16 bytes to 128 KB.
+//   realloc  : each task grows blocks by realloc from 16 bytes to 1 MB.
+//
+// Compile with -DSYSTEM_MALLOC to use the C library allocator (glibc __libc_malloc/__libc_free/__libc_realloc) under the
+// same runtime, for comparison with the uC++ heap.
+//
+// Usage: AllocBench [ processors (default 4) [ tasks per processor (default 1) [ scale (default 1) ] ] ]
+
+#include <iostream>
+using std::cout;
+using std::cerr;
+using std::osacquire;
+using std::endl;
+#include <cstdlib>					// atoi
+#include <cstring>					// memcpy
+#include <cstdio>					// sscanf
+#include <fcntl.h>					// open
+#include <unistd.h>					// read, sysconf
+#include <time.h>					// clock_gettime
+#include <sys/resource.h>				// getrusage
+
+unsigned int uDefaultPreemption() {
+    return 0;
+} // uDefaultPreemption
+
+#ifdef SYSTEM_MALLOC
+extern "C" void *__libc_malloc( size_t size );
+extern "C" void __libc_free( void *addr );
+extern "C" void *__libc_realloc( void *addr, size_t size );
+
+static const char *Allocator = "system";
+static inline void *Malloc( size_t size ) { return __libc_malloc( size ); }
+static inline void Free( void *addr ) { __libc_free( addr ); }
+static inline void *Realloc( void *addr, size_t size ) { return __libc_realloc( addr, size ); }
+#else
+static const char *Allocator = "uC++";
+static inline void *Malloc( size_t size ) { return malloc( size ); }
+static inline void Free( void *addr ) { free( addr ); }
+static inline void *Realloc( void *addr, size_t size ) { return realloc( addr, size ); }
+#endif // SYSTEM_MALLOC
+
+enum { MinSize = 16, MaxSize = 512,			// random block sizes for larson and prodcons
+       Slots = 1000,				// blocks per larson task
+       Generations = 10,				// larson task generations
+       Batch = 64,					// blocks passed at a time by prodcons, allocated at a time by sweep
+       BufferSize = 16 };				// batches in a prodcons buffer
+
+static inline unsigned int Rand( unsigned int &seed ) {	// xorshift
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed;
+} // Rand
+
+static inline size_t RandSize( unsigned int &seed ) {
+    return MinSize + Rand( seed ) % ( MaxSize - MinSize + 1 );
+} // RandSize
+
+static double Now() {					// wall-clock time in seconds
+    timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ts.tv_sec + ts.tv_nsec / 1.0E9;
+} // Now
+
+static long int RSS() {					// resident set size in kilobytes
+    char buf[128];
+    int fd = open( "/proc/self/statm", O_RDONLY );
+  if ( fd == -1 ) return -1;
+    ssize_t len = read( fd, buf, sizeof(buf) - 1 );
+    close( fd );
+  if ( len <= 0 ) return -1;
+    buf[len] = '\0';
+    long int size, resident;
+  if ( sscanf( buf, "%ld %ld", &size, &resident ) != 2 ) return -1;
+    return resident * ( sysconf( _SC_PAGESIZE ) / 1024 );
+} // RSS
+
+static long int PeakRSS() {				// maximum resident set size in kilobytes
+    rusage usage;
+    getrusage( RUSAGE_SELF, &usage );
+    return usage.ru_maxrss;
+} // PeakRSS
+
+static void Report( const char *test, unsigned int processors, unsigned int tasks, size_t size, unsigned long long int ops, double seconds ) {
+    osacquire( cout ) << test << ',' << Allocator << ',' << processors << ',' << tasks << ',' << size << ',' << ops << ','
+		      << seconds << ',' << (unsigned long long int)( ops / seconds ) << ',' << RSS() << ',' << PeakRSS() << endl;
+} // Report
+
+
+//=======================================
+// larson
+//=======================================
+
+_Task Larson {
+    void **slots;
+    unsigned int rounds, seed;
+
+    void main() {
+	for ( unsigned int i = 0; i < rounds; i += 1 ) {
+	    unsigned int s = Rand( seed ) % Slots;
+	    Free( slots[s] );				// likely allocated by another task
+	    slots[s] = Malloc( RandSize( seed ) );
+	    *(char *)slots[s] = '\345';			// touch storage
+	} // for
+    } // Larson::main
+  public:
+    Larson( void **slots, unsigned int rounds, unsigned int seed ) : slots( slots ), rounds( rounds ), seed( seed ) {}
+}; // Larson
+
+void RunLarson( unsigned int processors, unsigned int tasks, unsigned int scale ) {
+    unsigned int rounds = 20000 * scale, seed = 1;
+    void ***slots = new void **[tasks];
+    for ( unsigned int t = 0; t < tasks; t += 1 ) {
+	slots[t] = new void *[Slots];
+	for ( unsigned int s = 0; s < Slots; s += 1 ) {
+	    slots[t][s] = Malloc( RandSize( seed ) );
+	} // for
+    } // for
+
+    Larson **workers = new Larson *[tasks];
+    double start = Now();
+    for ( unsigned int g = 0; g < Generations; g += 1 ) {
+	for ( unsigned int t = 0; t < tasks; t += 1 ) {	// take over the blocks of another task
+	    workers[t] = new Larson( slots[( t + g ) % tasks], rounds, t * 7919 + g + 1 );
+	} // for
+	for ( unsigned int t = 0; t < tasks; t += 1 ) {
+	    delete workers[t];
+	} // for
+    } // for
+    double seconds = Now() - start;
+    delete [] workers;
+    Report( "larson", processors, tasks, 0, 2ULL * Generations * tasks * rounds, seconds );
+
+    for ( unsigned int t = 0; t < tasks; t += 1 ) {
+	for ( unsigned int s = 0; s < Slots; s += 1 ) {
+	    Free( slots[t][s] );
+	} // for
+	delete [] slots[t];
+    } // for
+    delete [] slots;
+} // RunLarson
+
+
+//=======================================
+// prodcons
+//=======================================
+
+_Monitor Buffer {
+    void *elems[BufferSize][Batch];
+    unsigned int front, back, count;
+  public:
+    Buffer() : front( 0 ), back( 0 ), count( 0 ) {}
+
+    void insert( void *batch[] ) {
+	if ( count == BufferSize ) _Accept( remove );
+	memcpy( elems[back], batch, sizeof(elems[back]) );
+	back = ( back + 1 ) % BufferSize;
+	count += 1;
+    } // Buffer::insert
+
+    void remove( void *batch[] ) {
+	if ( count == 0 ) _Accept( insert );
+	memcpy( batch, elems[front], sizeof(elems[front]) );
+	front = ( front + 1 ) % BufferSize;
+	count -= 1;
+    } // Buffer::remove
+}; // Buffer
+
+_Task Producer {
+    Buffer &buffer;
+    unsigned int batches, seed;
+
+    void main() {
+	void *batch[Batch];
+	for ( unsigned int b = 0; b < batches; b += 1 ) {
+	    for ( unsigned int i = 0; i < Batch; i += 1 ) {
+		batch[i] = Malloc( RandSize( seed ) );
+		*(char *)batch[i] = '\345';		// touch storage
+	    } // for
+	    buffer.insert( batch );
+	} // for
+    } // Producer::main
+  public:
+    Producer( uCluster &cluster, Buffer &buffer, unsigned int batches, unsigned int seed ) :
+	uBaseTask( cluster ), buffer( buffer ), batches( batches ), seed( seed ) {}
+}; // Producer
+
+_Task Consumer {
+    Buffer &buffer;
+    unsigned int batches;
+
+    void main() {
+	void *batch[Batch];
+	for ( unsigned int b = 0; b < batches; b += 1 ) {
+	    buffer.remove( batch );
+	    for ( unsigned int i = 0; i < Batch; i += 1 ) {
+		Free( batch[i] );			// allocated on another processor
+	    } // for
+	} // for
+    } // Consumer::main
+  public:
+    Consumer( uCluster &cluster, Buffer &buffer, unsigned int batches ) :
+	uBaseTask( cluster ), buffer( buffer ), batches( batches ) {}
+}; // Consumer
+
+void RunProdCons( unsigned int processors, unsigned int tasks, unsigned int scale ) {
+    unsigned int half = processors / 2 > 0 ? processors / 2 : 1; // processors per cluster
+    unsigned int pairs = tasks / 2 > 0 ? tasks / 2 : 1;
+    unsigned int batches = 4000 * scale;
+    uCluster producers( "producers" ), consumers( "consumers" );
+    uProcessor **cpus = new uProcessor *[2 * half];
+    for ( unsigned int i = 0; i < half; i += 1 ) {
+	cpus[i] = new uProcessor( producers );
+	cpus[half + i] = new uProcessor( consumers );
+    } // for
+
+    Buffer *buffers = new Buffer[pairs];
+    Producer **prods = new Producer *[pairs];
+    Consumer **cons = new Consumer *[pairs];
+    double start = Now();
+    for ( unsigned int p = 0; p < pairs; p += 1 ) {
+	cons[p] = new Consumer( consumers, buffers[p], batches );
+	prods[p] = new Producer( producers, buffers[p], batches, p * 7919 + 1 );
+    } // for
+    for ( unsigned int p = 0; p < pairs; p += 1 ) {
+	delete prods[p];
+	delete cons[p];
+    } // for
+    double seconds = Now() - start;
+    Report( "prodcons", 2 * half, 2 * pairs, 0, 2ULL * pairs * batches * Batch, seconds );
+
+    delete [] cons;
+    delete [] prods;
+    delete [] buffers;
+    for ( unsigned int i = 0; i < 2 * half; i += 1 ) {
+	delete cpus[i];
+    } // for
+    delete [] cpus;
+} // RunProdCons
+
+
+//=======================================
+// sweep
+//=======================================
+
+_Task Sweep {
+    size_t size;
+    unsigned int rounds;
+
+    void main() {
+	void *batch[Batch];
+	for ( unsigned int r = 0; r < rounds; r += 1 ) {
+	    for ( unsigned int i = 0; i < Batch; i += 1 ) {
+		batch[i] = Malloc( size );
+		*(char *)batch[i] = '\345';		// touch storage
+	    } // for
+	    for ( unsigned int i = 0; i < Batch; i += 1 ) {
+		Free( batch[i] );
+	    } // for
+	} // for
+    } // Sweep::main
+  public:
+    Sweep( size_t size, unsigned int rounds ) : size( size ), rounds( rounds ) {}
+}; // Sweep
+
+void RunSweep( unsigned int processors, unsigned int tasks, unsigned int scale ) {
+    static const size_t sizes[] = { 16, 24, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024, 1536, 2048,
+				    4096, 8192, 16384, 32768, 65536, 131072 };
+    Sweep **workers = new Sweep *[tasks];
+    for ( unsigned int s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s += 1 ) {
+	// Large sizes touch more storage per operation and may be mmapped, so they do fewer rounds.
+	unsigned int rounds = scale * ( sizes[s] <= 1024 ? 2000 : 2000 * 1024 / sizes[s] + 10 );
+	double start = Now();
+	for ( unsigned int t = 0; t < tasks; t += 1 ) {
+	    workers[t] = new Sweep( sizes[s], rounds );
+	} // for
+	for ( unsigned int t = 0; t < tasks; t += 1 ) {
+	    delete workers[t];
+	} // for
+	double seconds = Now() - start;
+	Report( "sweep", processors, tasks, sizes[s], 2ULL * tasks * rounds * Batch, seconds );
+    } // for
+    delete [] workers;
+} // RunSweep
+
+
+//=======================================
+// realloc
+//=======================================
+
+enum { ReallocMax = 1024 * 1024 };
+
+static unsigned int ReallocSteps() {			// reallocs in one chain
+    unsigned int steps = 0;
+    for ( size_t s = MinSize; s <= ReallocMax; s += s / 8 + MinSize ) steps += 1;
+    return steps;
+} // ReallocSteps
+
+_Task ReallocChain {
+    unsigned int chains;
+
+    void main() {
+	for ( unsigned int c = 0; c < chains; c += 1 ) {
+	    char *area = NULL;
+	    for ( size_t s = MinSize; s <= ReallocMax; s += s / 8 + MinSize ) { // grow by 1/8
+		area = (char *)Realloc( area, s );
+		area[s - 1] = '\345';			// touch new storage
+	    } // for
+	    Free( area );
+	} // for
+    } // ReallocChain::main
+  public:
+    ReallocChain( unsigned int chains ) : chains( chains ) {}
+}; // ReallocChain
+
+void RunRealloc( unsigned int processors, unsigned int tasks, unsigned int scale ) {
+    unsigned int chains = 100 * scale;
+    ReallocChain **workers = new ReallocChain *[tasks];
+    double start = Now();
+    for ( unsigned int t = 0; t < tasks; t += 1 ) {
+	workers[t] = new ReallocChain( chains );
+    } // for
+    for ( unsigned int t = 0; t < tasks; t += 1 ) {
+	delete workers[t];
+    } // for
+    double seconds = Now() - start;
+    delete [] workers;
+    Report( "realloc", processors, tasks, ReallocMax, (unsigned long long int)tasks * chains * ( ReallocSteps() + 1 ), seconds );
+} // RunRealloc
+
+
+void uMain::main() {
+    unsigned int processors = 4, perProcessor = 1, scale = 1;
+    if ( argc > 1 ) processors = atoi( argv[1] );
+    if ( argc > 2 ) perProcessor = atoi( argv[2] );
+    if ( argc > 3 ) scale = atoi( argv[3] );
+    if ( argc > 4 || processors == 0 || perProcessor == 0 || scale == 0 ) {
+	osacquire( cerr ) << "Usage: " << argv[0] << " [ processors (> 0) [ tasks per processor (> 0) [ scale (> 0) ] ] ]" << endl;
+	exit( EXIT_FAILURE );
+    } // if
+    unsigned int tasks = processors * perProcessor;
+
+    osacquire( cout ) << "test,allocator,processors,tasks,size,operations,seconds,ops/sec,rss kB,peak rss kB" << endl;
+    {
+	uProcessor *cpus = new uProcessor[processors - 1]; // uMain's processor is the other one
+	RunLarson( processors, tasks, scale );
+	RunSweep( processors, tasks, scale );
+	RunRealloc( processors, tasks, scale );
+	delete [] cpus;
+    }
+    RunProdCons( processors, tasks, scale );		// on its own clusters
+} // uMain::main
+
+// Local Variables: //
+// compile-command: "../../bin/u++ -O2 -multi -nodebug AllocBench.cc" //
+// End: //
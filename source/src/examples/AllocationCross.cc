@@ -0,0 +1,120 @@
+//                              -*- Mode: C++ -*-
+//
+// uC++ Version 6.1.0, Copyright (C) agent 2026
+//
+// AllocationCross.cc -- Free storage on a different processor from the one that allocated it.
+//
+// Author           : agent
+// Created On       : Sun Oct 18 06:09:31 2026
+// Last Modified By : agent
+// Last Modified On : Sun Oct 18 06:36:16 2026
+// Update Count     : 2
+//
+// This  library is free  software; you  can redistribute  it and/or  modify it
+// under the terms of the GNU Lesser General Public License as published by the
+// Free Software  Foundation; either  version 2.1 of  the License, or  (at your
+// option) any later version.
+//
+// This library is distributed in the  hope that it will be useful, but WITHOUT
+// ANY  WARRANTY;  without even  the  implied  warranty  of MERCHANTABILITY  or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+// for more details.
+//
+// You should  have received a  copy of the  GNU Lesser General  Public License
+// along  with this library.
+//
+
+// Producers on one cluster allocate small blocks, including blocks of the aligned size classes, and pass them to
+// consumers on another cluster, which check and free them. Each cluster has its own processor, so every block is
+// allocated from one processor's cache and freed into the other's, and the blocks flushed from the consumer's cache
+// are refilled into the producer's.
+
+#include <malloc.h>					// memalign, malloc_stats
+#include <cstring>					// memset
+#include <iostream>
+using std::cout;
+using std::endl;
+
+enum { NoOfBlocks = 200000, BufferSize = 64, MaxSize = 1024 };
+
+_Monitor Buffer {
+    uCondition full, empty;
+    char *elements[BufferSize];
+    int front, back, count;
+  public:
+    Buffer() : front( 0 ), back( 0 ), count( 0 ) {}
+
+    void insert( char *block ) {
+	if ( count == BufferSize ) empty.wait();
+	elements[back] = block;
+	back = ( back + 1 ) % BufferSize;
+	count += 1;
+	full.signal();
+    } // Buffer::insert
+
+    char *remove() {
+	if ( count == 0 ) full.wait();
+	char *block = elements[front];
+	front = ( front + 1 ) % BufferSize;
+	count -= 1;
+	empty.signal();
+	return block;
+    } // Buffer::remove
+}; // Buffer
+
+static size_t blockSize( int i ) {
+    return i % MaxSize + 1;
+} // blockSize
+
+_Task Producer {
+    Buffer &buffer;
+
+    void main() {
+	for ( int i = 0; i < NoOfBlocks; i += 1 ) {
+	    size_t size = blockSize( i );
+	    char *block = (char *)( i % 3 == 0 ? memalign( i % 2 == 0 ? 64 : 128, size ) : malloc( size ) );
+	  if ( block == NULL ) uAbort( "cross-processor malloc out of memory" );
+	    memset( block, i & 0xff, size );
+	    buffer.insert( block );
+	} // for
+    } // Producer::main
+  public:
+    Producer( uCluster &cluster, Buffer &buffer ) : uBaseTask( cluster ), buffer( buffer ) {}
+}; // Producer
+
+_Task Consumer {
+    Buffer &buffer;
+
+    void main() {
+	for ( int i = 0; i < NoOfBlocks; i += 1 ) {
+	    size_t size = blockSize( i );
+	    char *block = buffer.remove();
+	    if ( i % 3 == 0 && (uintptr_t)block % ( i % 2 == 0 ? 64 : 128 ) != 0 ) {
+		uAbort( "cross-processor memalign bad alignment : %p", block );
+	    } // if
+	    for ( size_t k = 0; k < size; k += 1 ) {
+		if ( block[k] != (char)( i & 0xff ) ) uAbort( "cross-processor malloc/free corrupt storage" );
+	    } // for
+	    free( block );
+	} // for
+    } // Consumer::main
+  public:
+    Consumer( uCluster &cluster, Buffer &buffer ) : uBaseTask( cluster ), buffer( buffer ) {}
+}; // Consumer
+
+void uMain::main() {
+    uCluster producers( "producers" ), consumers( "consumers" );
+    uProcessor processor1( producers ), processor2( consumers );
+    Buffer buffer;
+    {
+	Producer producer( producers, buffer );
+	Consumer consumer( consumers, buffer );
+    }
+    malloc_stats();
+    cout << "successful completion" << endl;
+} // uMain::main
+
+
+// Local Variables: //
+// compile-command: "u++-work -g -Wall -multi AllocationCross.cc" //
+// End: //
@@ -625,22 +625,48 @@ _Task TaskSignaller {
 
 _Task ContextSwitch {
     int N;
+    bool fp;
+    static volatile double f;				// prevent dead-code removal
 
-    void main() {    
+    void switches() {
 	long long int StartTime, EndTime;
+#if defined( __i386__ ) || defined( __x86_64__ )
+	unsigned long long int StartCycles, EndCycles;
+	StartCycles = uRead_tsc();
+#endif // __i386__ || __x86_64__
 
 	StartTime = Time();
 	for ( int i = 1; i <= N; i += 1 ) {
+	    if ( fp ) f += 1.5;				// floating-point live across the switch
 	    uYieldNoPoll();
 	} // for
 	EndTime = Time();
+#if defined( __i386__ ) || defined( __x86_64__ )
+	EndCycles = uRead_tsc();
+#endif // __i386__ || __x86_64__
 	osacquire( cerr ) << "\t " << ( EndTime - StartTime ) / N;
+#if defined( __i386__ ) || defined( __x86_64__ )
+	osacquire( cerr ) << "\t " << ( EndCycles - StartCycles ) / N;
+#else
+	osacquire( cerr ) << "\t N/A";
+#endif // __i386__ || __x86_64__
+    } // ContextSwitch::switches
+
+    void main() {    
+	if ( fp ) {
+	    uFloatingPointContext context;		// save/restore floating point registers during context switch
+	    switches();
+	} else {
+	    switches();
+	} // if
     } // ContextSwitch::main
   public:
-    ContextSwitch( int N ) {
+    ContextSwitch( int N, bool fp = false ) {
 	ContextSwitch::N = N;
+	ContextSwitch::fp = fp;
     } // ContextSwitch
 }; // ContextSwitch
+volatile double ContextSwitch::f;
 
 //=======================================
 // benchmark driver
@@ -734,11 +760,27 @@ void uMain::main() {
     }
     osacquire( cerr ) << "\t" << endl;
 
+    osacquire( cerr ) << "task nc\t";			// no stack cache: every creation allocates a stack
+    {
+	unsigned int cache = uThisCluster().setStackCache( 0 );
+	BlockTaskCreateDelete( NoOfTimes );
+	DynamicTaskCreateDelete( NoOfTimes );
+	uThisCluster().setStackCache( cache );
+    }
+    osacquire( cerr ) << "\t" << endl;
+
+    osacquire( cerr ) << "\n\t\tnsecs\tcycles" << endl;
     osacquire( cerr ) << "cxt sw\t";
     {
 	ContextSwitch dummy( NoOfTimes );		// context switch
     }
     osacquire( cerr ) << "\t" << endl;
+
+    osacquire( cerr ) << "cxt sw fp";			// context switch with floating-point context
+    {
+	ContextSwitch dummy( NoOfTimes, true );
+    }
+    osacquire( cerr ) << "\t" << endl;
 } // uMain::main
 
 // Local Variables: //
@@ -0,0 +1,124 @@
+//                              -*- Mode: C++ -*-
+//
+// uC++ Version 6.1.0, Copyright (C) agent 2026
+//
+// EventList.cc -- Timing benchmark for adding and removing timeout events with many pending events.
+//
+// Author           : agent
+// Created On       : Sun Oct 18 04:51:41 2026
+// Last Modified By : agent
+// Last Modified On : Sun Oct 18 06:36:16 2026
+// Update Count     : 3
+//
+// This  library is free  software; you  can redistribute  it and/or  modify it
+// under the terms of the GNU Lesser General Public License as published by the
+// Free Software  Foundation; either  version 2.1 of  the License, or  (at your
+// option) any later version.
+//
+// This library is distributed in the  hope that it will be useful, but WITHOUT
+// ANY  WARRANTY;  without even  the  implied  warranty  of MERCHANTABILITY  or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+// for more details.
+//
+// You should  have received a  copy of the  GNU Lesser General  Public License
+// along  with this library.
+//
+
+// Each waiter blocks on a semaphore with a long timeout, leaving one pending event on the event list.  The main task
+// then repeatedly blocks with a timeout that is woken by a partner task, so each cycle adds and removes one event from
+// a list holding the given number of pending events.  The cycle with no pending events is the context-switch cost.
+
+#include <uSemaphore.h>
+#include <iostream>
+using std::cerr;
+using std::osacquire;
+using std::endl;
+#include <cstdlib>					// atoi
+
+unsigned int uDefaultPreemption() {
+    return 0;
+} // uDefaultPreemption
+
+#include "Time.h"
+
+uSemaphore waiting( 0 ), ping( 0 ), pong( 0 );
+volatile unsigned int blocked = 0;
+
+_Task Waiter {
+    void main() {
+	blocked += 1;
+	waiting.P( uDuration( 1000 ) );			// pending event, alarm before those of the main task
+    } // Waiter::main
+  public:
+    Waiter() : uBaseTask( 16 * 1024 ) {}		// small stack, many waiters
+}; // Waiter
+
+_Task Partner {
+    int N;
+
+    void main() {
+	for ( int i = 0; i < N; i += 1 ) {
+	    ping.P();
+	    pong.V();
+	} // for
+    } // Partner::main
+  public:
+    Partner( int N ) : N( N ) {}
+}; // Partner
+
+void AddRemove( int N ) {
+    long long int StartTime, EndTime;
+    Partner partner( N );
+
+    StartTime = Time();
+    for ( int i = 0; i < N; i += 1 ) {
+	ping.V();
+	pong.P( uDuration( 2000 ) );			// add event, removed when partner wakes this task
+    } // for
+    EndTime = Time();
+    osacquire( cerr ) << "\t " << ( EndTime - StartTime ) / N;
+} // AddRemove
+
+void uMain::main() {
+    const int NoOfTimes =
+#if defined( __U_DEBUG__ )				// takes longer so run fewer iterations
+	10000;
+#else
+	100000;
+#endif // __U_DEBUG__
+    unsigned int MaxPending =				// 16K stack per waiter, so 10000 waiters use about 160MB
+#if defined( __U_DEBUG__ )				// guard page per stack limits the number of tasks
+	1000;
+#else
+	10000;
+#endif // __U_DEBUG__
+    if ( argc > 1 ) MaxPending = atoi( argv[1] );
+
+    Waiter **waiters = new Waiter *[MaxPending];
+    unsigned int created = 0;
+
+    osacquire( cerr ) << "pending\tadd/remove (nsecs)" << endl;
+    for ( unsigned int pending = 0;; pending = pending == 0 ? 10 : pending * 10 ) {
+	if ( pending > MaxPending ) pending = MaxPending;
+	for ( ; created < pending; created += 1 ) {
+	    waiters[created] = new Waiter;
+	} // for
+	while ( blocked < created ) yield();		// wait for waiters to block
+	osacquire( cerr ) << pending;
+	AddRemove( NoOfTimes );
+	osacquire( cerr ) << endl;
+      if ( pending == MaxPending ) break;
+    } // for
+
+    for ( unsigned int i = 0; i < created; i += 1 ) {
+	waiting.V();
+    } // for
+    for ( unsigned int i = 0; i < created; i += 1 ) {
+	delete waiters[i];
+    } // for
+    delete [] waiters;
+} // uMain::main
+
+// Local Variables: //
+// compile-command: "../../bin/u++ -O2 -nodebug EventList.cc" //
+// End: //
@@ -0,0 +1,143 @@
+//                              -*- Mode: C++ -*-
+//
+// uC++ Version 6.1.0, Copyright (C) agent 2026
+//
+// Splice.cc -- Forward a file to a socket and from a socket to a socket through pipes with splice.
+//
+// Author           : agent
+// Created On       : Sun Oct 18 06:23:33 2026
+// Last Modified By : agent
+// Last Modified On : Sun Oct 18 06:36:17 2026
+// Update Count     : 2
+//
+// This  library is free  software; you  can redistribute  it and/or  modify it
+// under the terms of the GNU Lesser General Public License as published by the
+// Free Software  Foundation; either  version 2.1 of  the License, or  (at your
+// option) any later version.
+//
+// This library is distributed in the  hope that it will be useful, but WITHOUT
+// ANY  WARRANTY;  without even  the  implied  warranty  of MERCHANTABILITY  or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+// for more details.
+//
+// You should  have received a  copy of the  GNU Lesser General  Public License
+// along  with this library.
+//
+
+// The sender splices the input file into a pipe and the pipe into a connection to the forwarder. The forwarder splices
+// that connection into a pipe and the pipe into a connection to the receiver, which reads the data and compares it
+// with the file. No data is copied through user buffers until the receiver. Transfers are not a multiple of the page
+// size, so the pipes hold partial pages.
+
+#include <uSocket.h>
+#include <iostream>
+using std::cout;
+using std::cerr;
+using std::osacquire;
+using std::endl;
+
+enum { Transfer = 3000,									// not a multiple of the page size
+	   BufferSize = 8 * 1024 };
+
+static uDuration timeout( 20 );							// seconds
+
+// Move len bytes already in the pipe to the destination.
+static void drain( uFileIO &dst, uPipe &pipe, ssize_t len ) {
+	while ( len > 0 ) {
+		len -= dst.splice( pipe.left(), NULL, NULL, len, SPLICE_F_MOVE, &timeout );
+	} // while
+} // drain
+
+_Task Sender {											// file => pipe => socket
+	uFile &input;
+	unsigned short port;
+
+	void main() {
+		uSocketClient client( port );
+		uFile::FileAccess in( input, O_RDONLY );
+		uPipe pipe;
+		off_t offset = 0;
+
+		for ( ;; ) {
+			ssize_t len = pipe.right().splice( in, &offset, NULL, Transfer, SPLICE_F_MOVE, &timeout );
+		  if ( len == 0 ) break;						// eof ?
+			drain( client, pipe, len );
+		} // for
+	} // Sender::main								// closing the connection ends the forwarder
+  public:
+	Sender( uFile &input, unsigned short port ) : input( input ), port( port ) {
+	} // Sender::Sender
+}; // Sender
+
+_Task Forwarder {										// socket => pipe => socket
+	uSocketServer &from, &to;
+
+	void main() {
+		uSocketAccept out( to ), in( from );
+		uPipe pipe;
+
+		for ( ;; ) {
+			ssize_t len = pipe.right().splice( in, NULL, NULL, Transfer, SPLICE_F_MOVE, &timeout );
+		  if ( len == 0 ) break;						// sender closed ?
+			drain( out, pipe, len );
+		} // for
+	} // Forwarder::main								// closing the connection ends the receiver
+  public:
+	Forwarder( uSocketServer &from, uSocketServer &to ) : from( from ), to( to ) {
+	} // Forwarder::Forwarder
+}; // Forwarder
+
+_Task Receiver {										// socket => compare with file
+	uFile &input;
+	unsigned short port;
+
+	void main() {
+		uSocketClient client( port );
+		uFile::FileAccess in( input, O_RDONLY );
+		char buf[BufferSize], check[BufferSize];
+		unsigned long int total = 0;
+
+		for ( ;; ) {
+			int len = client.read( buf, sizeof(buf), &timeout );
+		  if ( len == 0 ) break;						// forwarder closed ?
+			for ( int got = 0; got < len; ) {			// file reads may return less than asked
+				int cnt = in.read( check + got, len - got );
+				if ( cnt == 0 ) uAbort( "Error: more data forwarded than in the file" );
+				got += cnt;
+			} // for
+			for ( int i = 0; i < len; i += 1 ) {
+				if ( buf[i] != check[i] ) uAbort( "Error: forwarded data differs from the file at byte %lu", total + i );
+			} // for
+			total += len;
+		} // for
+		if ( in.read( check, 1 ) != 0 ) uAbort( "Error: less data forwarded than in the file" );
+		osacquire( cout ) << "forwarded " << total << " bytes" << endl;
+	} // Receiver::main
+  public:
+	Receiver( uFile &input, unsigned short port ) : input( input ), port( port ) {
+	} // Receiver::Receiver
+}; // Receiver
+
+void uMain::main() {
+	switch ( argc ) {
+	  case 2:
+		break;
+	  default:
+		cerr << "Usage: " << argv[0] << " input-file" << endl;
+		exit( EXIT_FAILURE );
+	} // switch
+
+	uFile input( argv[1] );
+	unsigned short fromPort, toPort;
+	uSocketServer from( &fromPort ), to( &toPort );		// any free ports on the local host
+	{
+		Forwarder forwarder( from, to );
+		Receiver receiver( input, toPort );
+		Sender sender( input, fromPort );
+	}
+} // uMain::main
+
+// Local Variables: //
+// tab-width: 4 //
+// compile-command: "u++-work Splice.cc" //
+// End: //
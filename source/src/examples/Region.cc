@@ -0,0 +1,107 @@
+//                              -*- Mode: C++ -*-
+//
+// uC++ Version 6.1.0, Copyright (C) agent 2026
+//
+// Region.cc -- Allocate from regions bound to tasks, release them and check the heap reuses their storage.
+//
+// Author           : agent
+// Created On       : Sun Oct 18 06:12:37 2026
+// Last Modified By : agent
+// Last Modified On : Sun Oct 18 06:36:16 2026
+// Update Count     : 2
+//
+// This  library is free  software; you  can redistribute  it and/or  modify it
+// under the terms of the GNU Lesser General Public License as published by the
+// Free Software  Foundation; either  version 2.1 of  the License, or  (at your
+// option) any later version.
+//
+// This library is distributed in the  hope that it will be useful, but WITHOUT
+// ANY  WARRANTY;  without even  the  implied  warranty  of MERCHANTABILITY  or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+// for more details.
+//
+// You should  have received a  copy of the  GNU Lesser General  Public License
+// along  with this library.
+//
+
+// Each worker fills a region with objects, a vector using the region allocator and a large block, checks the
+// contents, and releases the region, repeatedly. The last region of a worker is bound to it and released when its main
+// routine ends. Released chunks beyond the few spares kept for regions become free blocks, so the heap statistics show
+// the chunks freed and the storage in use returns to its starting level.
+
+#include <uRegion.h>
+#include <malloc.h>					// malloc_stats
+#include <vector>
+#include <iostream>
+using std::cout;
+using std::osacquire;
+using std::endl;
+
+enum { NoOfWorkers = 4, NoOfTimes = 100, NoOfObjects = 20000 };
+
+struct Node {
+    Node *next;
+    int value;
+    Node( Node *next, int value ) : next( next ), value( value ) {}
+}; // Node
+
+_Task Worker {
+    int id;
+    uRegion *bound;					// region bound to the task
+
+    void fill( uRegion &region, int times ) {
+	Node *list = NULL;
+	for ( int i = 0; i < NoOfObjects; i += 1 ) {
+	    list = new( region ) Node( list, i );
+	} // for
+	std::vector< int, uRegionAllocator<int> > v( ( uRegionAllocator<int>( region ) ) );
+	for ( int i = 0; i < NoOfObjects; i += 1 ) v.push_back( i + times );
+	char *large = (char *)region.alloc( 32 * 1024 );	// allocated separately from the chunks
+	if ( large == NULL ) uAbort( "region out of memory" );
+	large[0] = large[32 * 1024 - 1] = id;
+
+	int i = NoOfObjects;
+	for ( Node *n = list; n != NULL; n = n->next ) {
+	    i -= 1;
+	    if ( n->value != i ) uAbort( "region corrupt object storage" );
+	} // for
+	for ( int i = 0; i < NoOfObjects; i += 1 ) {
+	    if ( v[i] != i + times ) uAbort( "region corrupt vector storage" );
+	} // for
+	if ( large[0] != id || large[32 * 1024 - 1] != id ) uAbort( "region corrupt large storage" );
+    } // Worker::fill
+
+    void main() {
+	uRegion region;
+	for ( int t = 0; t < NoOfTimes; t += 1 ) {
+	    fill( region, t );
+	    region.release();
+	    if ( region.allocated() != 0 ) uAbort( "region not released" );
+	} // for
+
+	bound = new uRegion( *this );			// storage released when main ends
+	fill( *bound, NoOfTimes );
+    } // Worker::main
+  public:
+    Worker( int id ) : id( id ), bound( NULL ) {}
+    ~Worker() {
+	if ( bound->allocated() != 0 ) uAbort( "bound region not released when task ended" );
+	delete bound;
+    } // Worker::~Worker
+}; // Worker
+
+void uMain::main() {
+    uProcessor processors[NoOfWorkers - 1] __attribute__(( unused )); // more than one processor
+    {
+	Worker *workers[NoOfWorkers];
+	for ( int i = 0; i < NoOfWorkers; i += 1 ) workers[i] = new Worker( i );
+	for ( int i = 0; i < NoOfWorkers; i += 1 ) delete workers[i];
+    }
+    malloc_stats();
+    osacquire( cout ) << "successful completion" << endl;
+} // uMain::main
+
+
+// Local Variables: //
+// compile-command: "u++-work -g -Wall -multi Region.cc" //
+// End: //
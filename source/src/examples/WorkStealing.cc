@@ -0,0 +1,112 @@
+//                              -*- Mode: C++ -*-
+//
+// uC++ Version 6.1.0, Copyright (C) agent 2026
+//
+// WorkStealing.cc -- Run tasks on a cluster with a work-stealing ready queue while tasks migrate and processors are
+//    added and removed.
+//
+// Author           : agent
+// Created On       : Sun Oct 18 06:35:26 2026
+// Last Modified By : agent
+// Last Modified On : Sun Oct 18 06:35:26 2026
+// Update Count     : 1
+//
+// This  library is free  software; you  can redistribute  it and/or  modify it
+// under the terms of the GNU Lesser General Public License as published by the
+// Free Software  Foundation; either  version 2.1 of  the License, or  (at your
+// option) any later version.
+//
+// This library is distributed in the  hope that it will be useful, but WITHOUT
+// ANY  WARRANTY;  without even  the  implied  warranty  of MERCHANTABILITY  or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+// for more details.
+//
+// You should  have received a  copy of the  GNU Lesser General  Public License
+// along  with this library.
+//
+
+// The ready queue has fewer per-processor queues than the cluster has processors, so some processors use the overflow
+// queue. Workers yield repeatedly, so their processors and idle thieves move them among the queues, and periodically
+// migrate to the user cluster and back, so they are added from processors not on the cluster. Meanwhile, the program
+// deletes processors, whose queued tasks must be moved to the remaining queues, and creates new ones, which reuse the
+// freed queues. Every worker must finish all its iterations.
+
+#include <uWorkStealingScheduler.h>
+#include <iostream>
+using std::cout;
+using std::endl;
+
+enum { Capacity = 2, NoOfProcessors = 4, NoOfWorkers = 16, NoOfTimes = 20000, MigrateEvery = 500, NoOfRounds = 5 };
+
+volatile unsigned int iterations[NoOfWorkers];		// per worker, only written by the worker
+volatile unsigned int migrations = 0, finished = 0;
+
+_Task Worker {
+    uCluster &work, &user;
+    unsigned int id;
+
+    void main() {
+	for ( unsigned int i = 0; i < NoOfTimes; i += 1 ) {
+	    yield();
+	    if ( &uThisCluster() != &work ) uAbort( "Error: worker %u running on cluster %s", id, uThisCluster().getName() );
+	    iterations[id] += 1;
+	    if ( i % MigrateEvery == 0 ) {
+		migrate( user );				// leave the work-stealing cluster
+		yield();
+		migrate( work );				// return from a processor not on the cluster
+		uFetchAdd( migrations, 1 );
+	    } // if
+	} // for
+	uFetchAdd( finished, 1 );
+    } // Worker::main
+  public:
+    Worker( uCluster &work, uCluster &user, unsigned int id ) : uBaseTask( work ), work( work ), user( user ), id( id ) {
+    } // Worker::Worker
+}; // Worker
+
+void uMain::main() {
+    uWorkStealingScheduler rq( Capacity );
+    uCluster work( rq, "work" );
+    uProcessor *processors[NoOfProcessors];
+
+    for ( unsigned int p = 0; p < NoOfProcessors; p += 1 ) {
+	processors[p] = new uProcessor( work );
+    } // for
+    {
+	Worker *workers[NoOfWorkers];
+	for ( unsigned int w = 0; w < NoOfWorkers; w += 1 ) {
+	    workers[w] = new Worker( work, uThisCluster(), w );
+	} // for
+
+	// Processor 0 is never deleted, so the cluster always has a processor to run the workers.
+	for ( unsigned int r = 0; r < NoOfRounds; r += 1 ) {
+	    yield( 1000 );
+	    for ( unsigned int p = 1; p < NoOfProcessors; p += 1 ) {
+		delete processors[p];				// queued tasks move to the remaining queues
+		processors[p] = NULL;
+	    } // for
+	    yield( 1000 );
+	    for ( unsigned int p = 1; p < NoOfProcessors; p += 1 ) {
+		processors[p] = new uProcessor( work );		// reuse the freed queues
+	    } // for
+	} // for
+
+	for ( unsigned int w = 0; w < NoOfWorkers; w += 1 ) {
+	    delete workers[w];
+	} // for
+    }
+    for ( unsigned int p = 0; p < NoOfProcessors; p += 1 ) {
+	delete processors[p];
+    } // for
+
+    if ( finished != NoOfWorkers ) uAbort( "Error: %u of %u workers finished", finished, NoOfWorkers );
+    for ( unsigned int w = 0; w < NoOfWorkers; w += 1 ) {
+	if ( iterations[w] != NoOfTimes ) uAbort( "Error: worker %u ran %u of %u iterations", w, iterations[w], NoOfTimes );
+    } // for
+    if ( migrations != NoOfWorkers * ((NoOfTimes + MigrateEvery - 1) / MigrateEvery) ) uAbort( "Error: %u migrations", migrations );
+    cout << "successful completion" << endl;
+} // uMain::main
+
+// Local Variables: //
+// compile-command: "u++-work -g -Wall -multi WorkStealing.cc" //
+// End: //
@@ -45,6 +45,12 @@
 #define __U_KERNEL__
 #include <uC++.h>
 #include <unistd.h>					// access: getpid
+#include <cstdlib>					// malloc, free
+#ifdef __U_PROCESSOR_TIMERS__
+#include <cerrno>
+#include <cstring>					// strerror
+#include <sys/syscall.h>				// SYS_gettid
+#endif // __U_PROCESSOR_TIMERS__
 //#include <uDebug.h>
 
 
@@ -63,6 +69,8 @@ void uEventNode::createEventNode( uBaseTask *task, uSignalHandler *sig, uTime al
     uEventNode::task = task;
     sigHandler = sig;
     executeLocked = false;
+    eventList = NULL;
+    heapIndex = -1;
 } // uEventNode::createEventNode
 
 
@@ -87,7 +95,7 @@ void uEventNode::add( bool block ) {
     uDebugPrtBuf( buf, "(uEventNode &)%p.add( %d ) alarm:%lld period:%lld\n", this, block, alarm.nanoseconds(), period.nanoseconds() );
 #endif // __U_DEBUG_H__
 
-    uProcessor::events->addEvent( *this, block );
+    uThisProcessor().events->addEvent( *this, block );
 } // uEventNode::add
 
 
@@ -97,25 +105,264 @@ void uEventNode::remove() {
     uDebugPrtBuf( buf, "(uEventNode &)%p.remove alarm:%lld period:%lld\n", this, alarm.nanoseconds(), period.nanoseconds() );
 #endif // __U_DEBUG_H__
 
-    uProcessor::events->removeEvent( *this );
+    // The event is removed from the list it was added to, which may belong to another processor. With per-processor
+    // event lists, the event is moved to another list if that processor is deleted, so retry. The list of a deleted
+    // processor is recycled rather than freed, so it is safe to lock a list the event has left.
+
+    for ( ;; ) {
+	uEventList *list = eventList;
+      if ( list == NULL ) break;			// never added ?
+      if ( list->removeEvent( *this ) ) break;
+    } // for
 } // uEventNode::remove
 
 
 //######################### uEventList #########################
 
 
+// Pending events are kept in a 4-ary min-heap, so adding or removing an event is O(log n) rather than a linear walk of a
+// sorted list under the event lock. A 4-ary heap is shallower than a binary heap and the children of a node share a
+// cache line.
+
+uEventList::uEventList() {
+    heap = NULL;
+    heapSize = heapCapacity = count = 0;
+    tickets = 0;
+#ifdef __U_PROCESSOR_TIMERS__
+    timerCreated = false;
+#endif // __U_PROCESSOR_TIMERS__
+} // uEventList::uEventList
+
+
+void uEventList::heapUp( unsigned int pos ) {
+    uEventNode *event = heap[pos];
+    while ( pos > 0 ) {
+	unsigned int parent = ( pos - 1 ) / 4;
+      if ( ! before( event, heap[parent] ) ) break;
+	heap[pos] = heap[parent];
+	heap[pos]->heapIndex = pos;
+	pos = parent;
+    } // while
+    heap[pos] = event;
+    event->heapIndex = pos;
+} // uEventList::heapUp
+
+
+void uEventList::heapDown( unsigned int pos ) {
+    uEventNode *event = heap[pos];
+    for ( ;; ) {
+	unsigned int first = 4 * pos + 1;
+      if ( first >= heapSize ) break;			// no children ?
+	unsigned int last = first + 4 < heapSize ? first + 4 : heapSize;
+	unsigned int min = first;
+	for ( unsigned int c = first + 1; c < last; c += 1 ) {
+	    if ( before( heap[c], heap[min] ) ) min = c;
+	} // for
+      if ( ! before( heap[min], event ) ) break;
+	heap[pos] = heap[min];
+	heap[pos]->heapIndex = pos;
+	pos = min;
+    } // for
+    heap[pos] = event;
+    event->heapIndex = pos;
+} // uEventList::heapDown
+
+
+void uEventList::heapInsert( uEventNode &event ) {
+    assert( heapSize < heapCapacity );			// count <= heapCapacity
+    event.ticket = tickets;
+    tickets += 1;
+    heap[heapSize] = &event;
+    heapSize += 1;
+    heapUp( heapSize - 1 );
+    event.eventList = this;
+} // uEventList::heapInsert
+
+
+void uEventList::grow( unsigned int capacity ) {
+    // The heap is only extended from task context without the event lock, so the allocation is not performed with
+    // interrupts disabled or during a roll forward, except for the first event on an empty list. The heap capacity is
+    // never less than the number of events in the heap or the expired queue, so reinserting a periodic event never
+    // extends the heap.
+
+    uEventNode **storage = (uEventNode **)malloc( capacity * sizeof( uEventNode * ) );
+    if ( storage == NULL ) {
+	uAbort( "(uEventList &)%p.grow( %u ) : internal error, unable to extend event heap.", this, capacity );
+    } // if
+    eventLock.acquire();
+    if ( heapCapacity < capacity ) {			// not extended by another task ?
+	memcpy( storage, heap, heapSize * sizeof( uEventNode * ) );
+	uEventNode **old = heap;
+	heap = storage;
+	heapCapacity = capacity;
+	storage = old;
+    } // if
+    eventLock.release();
+    free( storage );					// old heap or unused storage
+} // uEventList::grow
+
+
+void uEventList::heapRemove( uEventNode &event ) {
+    unsigned int pos = event.heapIndex;
+    event.heapIndex = -1;
+    heapSize -= 1;
+  if ( pos == heapSize ) return;			// removed last element ?
+    uEventNode *last = heap[heapSize];			// fill hole with last element
+    heap[pos] = last;
+    last->heapIndex = pos;
+    if ( pos > 0 && before( last, heap[( pos - 1 ) / 4] ) ) {
+	heapUp( pos );
+    } else {
+	heapDown( pos );
+    } // if
+} // uEventList::heapRemove
+
+
+void uEventList::expire( uTime time ) {
+    // Move all events expiring by the given time to the expired queue in a single pass under the event lock, so roll
+    // forward does not search the heap for each expired event.
+
+    while ( heapSize != 0 && heap[0]->alarm <= time ) {
+	uEventNode *event = heap[0];
+	heapRemove( *event );
+	expired.addTail( event );
+    } // while
+} // uEventList::expire
+
+
+#ifdef __U_PROCESSOR_TIMERS__
+void uEventList::createTimer() {
+    // Must be called by the kernel thread of the processor owning this list, which receives the SIGALRM when the timer
+    // expires. SIGALRM is process directed only with ITIMER_REAL, so all kernel threads accept it in this mode.
+
+    sigset_t mask;
+    sigemptyset( &mask );
+    sigaddset( &mask, SIGALRM );
+    if ( sigprocmask( SIG_UNBLOCK, &mask, NULL ) == -1 ) {
+	uAbort( "internal error, sigprocmask" );
+    } // if
+
+    sigevent sev;
+    memset( &sev, 0, sizeof( sev ) );
+    sev.sigev_notify = SIGEV_THREAD_ID;
+    sev.sigev_signo = SIGALRM;
+    sev._sigev_un._tid = syscall( SYS_gettid );
+    if ( timer_create( CLOCK_REALTIME, &sev, &timer ) == -1 ) {
+	uAbort( "(uEventList &)%p.createTimer() : internal error, timer_create failed, error(%d) %s.", this, errno, strerror( errno ) );
+    } // if
+
+    eventLock.acquire();
+    timerCreated = true;
+    if ( head() != NULL ) {				// events added before kernel thread started ?
+	setTimer( head()->alarm );
+    } // if
+    eventLock.release();
+} // uEventList::createTimer
+
+
+void uEventList::transfer( uEventList &to, uEventNode *ignore ) {
+    // Move pending events to another list because the processor owning this list is being deleted. Lock order is
+    // destination then source: a handler executed with the destination lock held may remove an event from this list,
+    // but nothing holding this lock acquires another list lock.
+
+    for ( ;; ) {
+	to.eventLock.acquire();
+	eventLock.acquire();
+      if ( to.count + count < to.heapCapacity ) break;	// room for all events and a context-switch event ?
+	unsigned int capacity = ( to.count + count ) * 2;
+	eventLock.release();
+	to.eventLock.release();
+	to.grow( capacity );
+    } // for
+    while ( heapSize != 0 ) {
+	uEventNode *event = heap[heapSize - 1];		// removing last element does not reorder heap
+	heapRemove( *event );
+      if ( event == ignore ) continue;			// processor's own context-switch event
+	to.heapInsert( *event );
+	to.count += 1;
+    } // while
+    for ( uEventNode *event = expired.dropHead(); event != NULL; event = expired.dropHead() ) {
+      if ( event == ignore ) continue;
+	to.heapInsert( *event );
+	to.count += 1;
+    } // for
+    count = 0;
+    eventLock.release();
+    if ( to.head() != NULL ) {
+	to.setTimer( to.head()->alarm );		// head may have changed
+    } // if
+    to.eventLock.release();
+} // uEventList::transfer
+
+
+uSpinLock uEventList::sparesLock;
+uEventList *uEventList::spares = NULL;
+
+
+uEventList *uEventList::create() {
+    sparesLock.acquire();
+    uEventList *list = spares;
+    if ( list != NULL ) spares = list->nextSpare;
+    sparesLock.release();
+    if ( list == NULL ) list = new uEventList;
+    return list;
+} // uEventList::create
+
+
+void uEventList::recycle() {
+    // A task in uEventNode::remove may have loaded this list just before its events were transferred, and then
+    // acquires the list lock to find the event has moved. Therefore, the list of a deleted processor is never freed,
+    // but reused by the next processor created. The timer belongs to the deleted kernel thread.
+
+    eventLock.acquire();
+    if ( timerCreated ) {
+	timer_delete( timer );
+	timerCreated = false;
+    } // if
+    eventLock.release();
+
+    sparesLock.acquire();
+    nextSpare = spares;
+    spares = this;
+    sparesLock.release();
+} // uEventList::recycle
+#endif // __U_PROCESSOR_TIMERS__
+
+
+uEventList::~uEventList() {
+#ifdef __U_PROCESSOR_TIMERS__
+    if ( timerCreated ) {
+	timer_delete( timer );
+    } // if
+#endif // __U_PROCESSOR_TIMERS__
+    free( heap );
+} // uEventList::~uEventList
+
+
 void uEventList::addEvent( uEventNode &newEvent, bool block ) {
 #ifdef __U_DEBUG_H__
     char buf[1024];
     uDebugPrtBuf( buf, "(uEventList &)%p.addEvent, newEvent:%p\n", this, &newEvent );
 #endif // __U_DEBUG_H__
 
+    // Double the heap when it becomes 3/4 full, so concurrent additions rarely find it full. Task additions leave one
+    // slot spare for the processor's context-switch event, which the kernel adds with interrupts disabled.
+
+    unsigned int reserve = THREAD_GETMEM( disableInt ) ? 0 : 1;
+    if ( ( count + 1 + reserve ) * 4 > heapCapacity * 3 ) { // racy read, rechecked by grow
+	grow( heapCapacity == 0 ? 64 : heapCapacity * 2 );
+    } // if
     eventLock.acquire();
+    while ( count + reserve >= heapCapacity ) {		// filled by concurrent additions ?
+	unsigned int capacity = heapCapacity == 0 ? 64 : heapCapacity * 2;
+	eventLock.release();
+	grow( capacity );
+	eventLock.acquire();
+    } // while
 
-    uEventNode *event;
-    for ( uSeqIter<uEventNode> iter( eventlist ); iter >> event && event->alarm <= newEvent.alarm; ); // find position to insert
-    eventlist.insertBef( &newEvent, event );		// insert in list
-    if ( eventlist.head() == &newEvent ) {		// inserted at front ?
+    count += 1;
+    heapInsert( newEvent );
+    if ( head() == &newEvent ) {			// inserted at front ?
 	setTimer( newEvent.alarm );			// reset alarm
     } // if
 
@@ -127,7 +374,73 @@ void uEventList::addEvent( uEventNode &newEvent, bool block ) {
 } // uEventList::addEvent
 
 
-void uEventList::removeEvent( uEventNode &event ) {
+#ifdef __U_TICKLESS__
+void uEventList::armSlice( uProcessor &processor, uTime alarm, uDuration period ) {
+    // A time slice is armed by its processor or by a processor on another cluster making a task ready, so the pending
+    // check and insertion are done under the event lock to add the event once. A pending slice is left alone, which
+    // avoids resetting the timer on each dispatch. The spare slot kept by addEvent means the heap is rarely extended.
+    // The slice is counted by the processor's cluster until it lapses or is disarmed, so a task made ready on the
+    // cluster does not scan its processors while one is timing a slice.
+
+    uEventNode &event = *processor.contextEvent;
+    eventLock.acquire();
+  if ( event.pending() ) {				// already armed ?
+	eventLock.release();
+	return;
+    } // if
+    while ( count >= heapCapacity ) {			// first event on an empty list ?
+	unsigned int capacity = heapCapacity == 0 ? 64 : heapCapacity * 2;
+	eventLock.release();
+	grow( capacity );
+	eventLock.acquire();
+      if ( event.pending() ) {
+	    eventLock.release();
+	    return;
+	} // if
+    } // while
+
+    event.alarm = alarm;
+    event.period = period;
+    count += 1;
+    heapInsert( event );
+    processor.sliceCluster = processor.currCluster;
+    uFetchAdd( processor.sliceCluster->slicesArmed, 1 );
+    if ( head() == &event ) {				// inserted at front ?
+	setTimer( alarm );				// reset alarm
+    } // if
+    eventLock.release();
+} // uEventList::armSlice
+
+
+uCluster *uEventList::disarmSlice( uProcessor &processor ) {
+    uEventNode &event = *processor.contextEvent;
+    eventLock.acquire();
+  if ( ! event.pending() ) {				// not armed or lapsed ?
+	eventLock.release();
+	return NULL;
+    } // if
+    if ( event.heapIndex == -1 ) {			// expired but handler not executed ?
+	expired.remove( &event );
+    } else if ( event.heapIndex == 0 ) {		// remove at head ? => reset alarm
+	heapRemove( event );
+	if ( head() == NULL ) {				// heap empty ?
+	    setTimer( uDuration( 0 ) );			// cancel alarm
+	} else {
+	    setTimer( head()->alarm );			// reset alarm
+	} // if
+    } else {
+	heapRemove( event );
+    } // if
+    count -= 1;
+    uCluster *cluster = processor.sliceCluster;
+    uFetchAdd( cluster->slicesArmed, -1 );
+    eventLock.release();
+    return cluster;
+} // uEventList::disarmSlice
+#endif // __U_TICKLESS__
+
+
+bool uEventList::removeEvent( uEventNode &event ) {
 #ifdef __U_DEBUG_H__
     char buf[1024];
     uDebugPrtBuf( buf, "(uEventList &)%p.removeEvent, event:%p\n", this, &event );
@@ -135,25 +448,34 @@ void uEventList::removeEvent( uEventNode &event ) {
 
     eventLock.acquire();
 
+  if ( event.eventList != this ) {			// moved to another list ?
+	eventLock.release();
+	return false;
+    } // if
+
     // If a task is trying to remove an event at the same time the event expires, both the task and roll forward race to
     // remove the event.  One succeeds and the other finds the node not listed.
-  if ( ! event.listed() ) {				// node already removed ?
+  if ( ! event.pending() ) {				// node already removed ?
 	eventLock.release();
-	return;
+	return true;
     } // if
 
-    uEventNode *head = eventlist.head();
-    eventlist.remove( &event );
-
-    if ( head == &event ) {				// remove at head ? => reset alarm
-	if ( eventlist.empty() ) {			// list empty ?
+    if ( event.heapIndex == -1 ) {			// expired but handler not executed ?
+	expired.remove( &event );
+    } else if ( event.heapIndex == 0 ) {		// remove at head ? => reset alarm
+	heapRemove( event );
+	if ( head() == NULL ) {				// heap empty ?
 	    setTimer( uDuration( 0 ) );			// cancel alarm
 	} else {
-	    setTimer( eventlist.head()->alarm );	// reset alarm
+	    setTimer( head()->alarm );			// reset alarm
 	} // if
+    } else {
+	heapRemove( event );
     } // if
+    count -= 1;
 
     eventLock.release();
+    return true;
 } // uEventList::removeEvent
 
 
@@ -161,20 +483,21 @@ void uEventList::removeEvent( uEventNode &event ) {
 bool uEventList::userEventPresent() {
     eventLock.acquire();
 
-    uEventNode *event;
-    uSeqIter<uEventNode> iter(eventlist);
-
     // Only one context-switch event in uniprocessor as there is only one real processor and the other processors are
-    // simulated. Now check for any task waiting other than system task. Loop executes at most 3 iterations
-    for ( int i = 0; iter >> event && ( uProcessor::contextSwitchHandler == event->sigHandler // ignore context switch event
-					|| event->task == (uBaseTask *)uKernelModule::systemTask ); // ignore system task
-	  i += 1
-	) {
-	assert( i < 3 );
+    // simulated. Now check for any task waiting other than system task. The heap is unordered beyond its head, so
+    // search until a user event is found; at most 2 events are ignored.
+    bool present = false;
+    for ( unsigned int i = 0; i < heapSize; i += 1 ) {
+	uEventNode *event = heap[i];
+	if ( uProcessor::contextSwitchHandler != event->sigHandler // ignore context switch event
+	     && event->task != (uBaseTask *)uKernelModule::systemTask ) { // ignore system task
+	    present = true;
+	    break;
+	} // if
     } // for
     eventLock.release();
 
-    return event != NULL;
+    return present;
 } // uEventList::userEventPresent
 #endif // ! __U_MULTI__
 
@@ -185,7 +508,20 @@ void uEventList::setTimer( uDuration duration ) {
     uDebugPrtBuf( buf, "(uEventList &)%p.setTimer, duration %lld\n", this, duration.nanoseconds() );
 #endif // __U_DEBUG_H__
 
+#ifdef __U_PROCESSOR_TIMERS__
+  if ( ! timerCreated || duration < 0 ) return;		// armed by createTimer
+    itimerspec it;
+    it.it_value = duration;				// zero duration => disarm
+    if ( it.it_value.tv_sec == 0 && it.it_value.tv_nsec == 0 && duration.nanoseconds() > 0 ) it.it_value.tv_nsec = 1;
+    it.it_interval.tv_sec = 0;				// not periodic
+    it.it_interval.tv_nsec = 0;
+#ifdef __U_STATISTICS__
+    uFetchAdd( Statistics::setitimer, 1 );
+#endif // __U_STATISTICS__
+    timer_settime( timer, 0, &it, NULL );
+#else
     activeProcessorKernel->setTimer( duration );
+#endif // __U_PROCESSOR_TIMERS__
 } // uEventList::setTimer
 
 
@@ -212,8 +548,14 @@ void uEventList::setTimer( uTime time ) {		// time parameter is real-time (not v
 #ifdef __U_DEBUG_H__
 	uDebugPrtBuf( buffer, "uEventList::setTimer, kill time:%lld currtime:%lld dur:%lld\n", time.nanoseconds(), currtime.nanoseconds(), dur.nanoseconds() );
 #endif // __U_DEBUG_H__
+#ifdef __U_PROCESSOR_TIMERS__
+	// The list may belong to another processor, so expire its timer immediately rather than forcing a roll forward
+	// on this processor.
+	setTimer( uDuration( 0, 1 ) );
+#else
 	//kill( getpid(), SIGALRM );			// send SIGALRM immediately, works uni and multi processor
 	THREAD_SETMEM( RFpending, true );		// force rollForward to be called
+#endif // __U_PROCESSOR_TIMERS__
     } else {
 	setTimer( dur );
     } // if
@@ -235,9 +577,9 @@ void uEventListPop::over( uEventList &events, bool inKernel ) {
 
 
 uEventListPop::uEventListPop( uEventList &events, bool inKernel ) {
-#if defined( __U_MULTI__ )
+#if defined( __U_MULTI__ ) && ! defined( __U_PROCESSOR_TIMERS__ )
     assert( &uThisProcessor() == uKernelModule::systemProcessor );
-#endif // __U_MULTI__
+#endif // __U_MULTI__ && ! __U_PROCESSOR_TIMERS__
     over( events, inKernel );
 } // uEventListPop::uEventListPop
 
@@ -248,12 +590,12 @@ uEventListPop::~uEventListPop() {
     uDebugPrtBuf( buf, "(uEventListPop &)%p.~uEventListPop\n", this );
 #endif // __U_DEBUG_H__
 
-#if defined( __U_MULTI__ )
+#if defined( __U_MULTI__ ) && ! defined( __U_PROCESSOR_TIMERS__ )
     assert( &uThisProcessor() == uKernelModule::systemProcessor );
-#endif // __U_MULTI__
+#endif // __U_MULTI__ && ! __U_PROCESSOR_TIMERS__
 
     events->eventLock.acquire_( true );
-    uEventNode *head = events->eventlist.head();	// optimization
+    uEventNode *head = events->head();			// optimization
     if ( head != NULL && ! THREAD_GETMEM( RFpending ) ) { // reset timer to next available event
 	events->setTimer( head->alarm );
     } // if
@@ -293,9 +635,15 @@ bool uEventListPop::operator>>( uEventNode *&node ) {
 
     events->eventLock.acquire_( true );
 
-    node = events->eventlist.head();			// get event at the start of the list with the shortest time delay
+    // Expired events are removed from the heap in batches. An event in the batch remains listed until handed out, so
+    // a task removing its event before the handler executes takes it off the expired queue. Events added during the
+    // iteration that have already expired are picked up by the next batch.
+    if ( events->expired.empty() ) {
+	events->expire( currTime );
+    } // if
+    node = events->expired.dropHead();			// get event with the shortest time delay
 
-  if ( ! node ) {					// no events ?
+  if ( ! node ) {					// no expired events ?
 	events->eventLock.release_( true );
 	return false;
     } // if
@@ -304,29 +652,39 @@ bool uEventListPop::operator>>( uEventNode *&node ) {
     uDebugPrtBuf( buf, "(uEventListPop &)%p.>>, currTime:%lld node:%p %s alarm:%lld period:%lld\n", this, currTime.nanoseconds(), node, node->task != NULL ? node->task->getName() : "*noname*", node->alarm.nanoseconds(), node->period.nanoseconds() );
 #endif // __U_DEBUG_H__
 
-  if ( node->alarm > currTime ) {			// event time delay greater than the start time for the iteration
-	events->eventLock.release_( true );
-	return false;
+    uCxtSwtchHndlr *cxtSwEvent = dynamic_cast<uCxtSwtchHndlr *>(node->sigHandler);
+#ifdef __U_TICKLESS__
+    // The time slice is cancelled lazily: when it expires with no task waiting for the processor, it lapses rather
+    // than preempting and is armed again when competition appears. The check is made under the event lock, which a
+    // processor arming the slice after making a task ready also acquires. A task made ready that saw the slice
+    // counted does not arm, so competition is checked again after the slice is uncounted and the slice is kept if a
+    // task appeared.
+    if ( cxtSwEvent != NULL && ! cxtSwEvent->processor.competition() ) {
+	uCluster *cluster = cxtSwEvent->processor.sliceCluster;
+	uFetchAdd( cluster->slicesArmed, -1 );
+	if ( ! cxtSwEvent->processor.competition() ) {
+	    events->count -= 1;
+	    events->eventLock.release_( true );
+	    return true;
+	} // if
+	uFetchAdd( cluster->slicesArmed, 1 );		// task made ready during the check
     } // if
-
-    events->eventlist.remove( node );
+#endif // __U_TICKLESS__
 
     // If the popped event is periodic, reinsert for next period.
     if ( node->period != 0 ) {
 	node->alarm = currTime + node->period;		// reset time for next alarm
-
-	uEventNode *event;
 	// May have to order identical timed elements by priority (to keep up the real-time spirit)
-	for ( uSeqIter<uEventNode> iter( events->eventlist ); iter >> event && event->alarm <= node->alarm; );
-	events->eventlist.insertBef( node, event );	// insert into sorted position in list
+	events->heapInsert( *node );			// identical times ordered by insertion
+    } else {
+	events->count -= 1;
     } // if
 
-    uCxtSwtchHndlr *cxtSwEvent = dynamic_cast<uCxtSwtchHndlr *>(node->sigHandler);
     if ( cxtSwEvent != NULL ) {				// ContextSwitch event ?
 #if defined( __U_MULTI__ )
-	if ( &cxtSwEvent->processor == uKernelModule::systemProcessor ) {
+	if ( &cxtSwEvent->processor == &uThisProcessor() ) { // system processor, or any processor with its own list
 #endif // ! __U_MULTI__
-	    // Defer ContextSwitch for system processor until after all events processed so SIGUSR1 not delivered during
+	    // Defer ContextSwitch for this processor until after all events processed so SIGUSR1 not delivered during
 	    // event processing.
 	    assert( cxtSwHandler == NULL );
 	    cxtSwHandler = node->sigHandler;
@@ -29,6 +29,11 @@
 #define __U_ALARM_H__
 
 
+#ifdef __U_PROCESSOR_TIMERS__
+#include <ctime>					// timer_t
+#endif // __U_PROCESSOR_TIMERS__
+
+
 class uSignalHandler;					// forward declarations
 
 namespace UPP {
@@ -57,6 +62,9 @@ class uEventNode : public uSeqable {
     uBaseTask *task;					// task who created event
     uSignalHandler *sigHandler;				// action to perform when timer expires
     bool executeLocked;					// true => handler executed with uEventlock acquired
+    uEventList *eventList;				// list event was last added to
+    int heapIndex;					// position in event heap, -1 => not in heap
+    unsigned long int ticket;				// insertion order, breaks ties between identical alarms
 
     void createEventNode( uBaseTask *task, uSignalHandler *sig, uTime alarm, uDuration period );
     uEventNode();
@@ -65,6 +73,10 @@ class uEventNode : public uSeqable {
 
     void add( bool block = false );			// activate event
     void remove();					// deactivate event
+  public:
+    bool pending() const {				// in heap or expired but handler not executed
+	return heapIndex != -1 || uSeqable::listed();
+    } // uEventNode::pending
 }; // uEventNode
 
 
@@ -72,23 +84,58 @@ class uEventNode : public uSeqable {
 
 
 class uEventList {
-    friend _Coroutine UPP::uProcessorKernel;		// access: userEventPresent
+    friend _Coroutine UPP::uProcessorKernel;		// access: userEventPresent, createTimer
     friend class uSerial;				// access: addEvent, removeEvent
     friend class uCondLock;				// access: addEvent, removeEvent
     friend class UPP::uNBIO;				// access: addEvent, removeEvent, uNextAlarm
     friend class uBaseTask;				// access: addEvent
     friend class UPP::uKernelBoot;			// access: uEventList
-    friend class uProcessor;				// access: uEventList
-    friend class uEventListPop;				// access: eventLock, eventlist
+    friend class uProcessor;				// access: uEventList, ~uEventList, transfer, create, recycle, armSlice, disarmSlice
+    friend class uEventListPop;				// access: eventLock, head, expire, expired, heapInsert, count
     friend class uEventNode;				// access: addEvent, removeEvent
   protected:
     uSpinLock eventLock;				// protect EventQueue
-    uSequence<uEventNode> eventlist;			// event list
-
-    virtual ~uEventList() {}
+    uEventNode **heap;					// 4-ary min-heap of pending events ordered by alarm
+    unsigned int heapSize, heapCapacity;
+    unsigned int count;					// events in heap or expired queue, heap capacity is never less
+    unsigned long int tickets;				// next insertion ticket
+    uSequence<uEventNode> expired;			// popped by roll forward, handler not yet executed
+#ifdef __U_PROCESSOR_TIMERS__
+    timer_t timer;					// expires on the kernel thread of the processor owning the list
+    bool timerCreated;
+    uEventList *nextSpare;				// link in list of recycled event lists
+
+    static uSpinLock sparesLock;			// protect spares
+    static uEventList *spares;				// lists of deleted processors, reused by new processors
+
+    void createTimer();
+    void transfer( uEventList &to, uEventNode *ignore );
+    static uEventList *create();
+    void recycle();
+#endif // __U_PROCESSOR_TIMERS__
+
+    uEventList();
+    virtual ~uEventList();
+
+    uEventNode *head() const {				// event with the shortest time delay
+	return heapSize == 0 ? NULL : heap[0];
+    } // uEventList::head
+    static bool before( uEventNode *l, uEventNode *r ) {
+	return l->alarm < r->alarm || ( l->alarm == r->alarm && l->ticket < r->ticket );
+    } // uEventList::before
+    void heapUp( unsigned int pos );
+    void heapDown( unsigned int pos );
+    void heapInsert( uEventNode &event );
+    void grow( unsigned int capacity );			// called without event lock
+    void heapRemove( uEventNode &event );
+    void expire( uTime time );				// move expired events to expired queue
 
     void addEvent( uEventNode &newAlarm, bool block = false );
-    void removeEvent( uEventNode &event );
+    bool removeEvent( uEventNode &event );
+#ifdef __U_TICKLESS__
+    void armSlice( uProcessor &processor, uTime alarm, uDuration period ); // add time-slice event unless pending
+    uCluster *disarmSlice( uProcessor &processor );	// remove time-slice event, return cluster it was armed for
+#endif // __U_TICKLESS__
 
 #if ! defined( __U_MULTI__ )
     bool userEventPresent();
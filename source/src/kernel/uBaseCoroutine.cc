@@ -147,6 +147,7 @@ void uBaseCoroutine::contextSw() {			// switch between a task and the kernel
 
     uSwitch( coroutine.context, context );		// context switch to kernel
 
+    activeProcessorKernel->handoffDone();		// complete direct handoff to this task
     coroutine.restore();				// restore user specified contexts
 
 #if ! defined( __U_ERRNO_FUNC__ )
@@ -164,6 +165,58 @@ void uBaseCoroutine::contextSw() {			// switch between a task and the kernel
 } // uBaseCoroutine::contextSw
 
 
+void uBaseCoroutine::taskSw( uBaseTask &task ) {	// switch directly from the current task to a blocked task
+    uBaseCoroutine &coroutine = uThisCoroutine();	// optimization
+    uBaseTask &currTask = uThisTask();
+
+#ifdef __U_PROFILER__
+    if ( currTask.profileActive && uProfiler::uProfiler_builtinRegisterTaskBlock ) { // uninterruptable hooks
+	(*uProfiler::uProfiler_builtinRegisterTaskBlock)( uProfiler::profilerInstance, currTask );
+    } // if
+#endif // __U_PROFILER__
+
+    coroutine.setState( Inactive );			// set state of current coroutine to inactive
+
+#ifdef __U_DEBUG_H__
+    uDebugPrt( "(uBaseCoroutine &)%p.taskSw, coroutine:%p, coroutine.SP:%p, task:%p\n",
+	       this, &coroutine, coroutine.stackPointer(), &task );
+#endif // __U_DEBUG_H__
+
+#if ! defined( __U_ERRNO_FUNC__ )
+    coroutine.errno_ = errno;				// save
+#endif // ! __U_ERRNO_FUNC__
+    coroutine.save();					// save user specified contexts
+
+    THREAD_SETMEM( activeTask, &task );			// task now executes on this processor
+
+#if defined( __U_MULTI__ ) && defined( __U_SWAPCONTEXT__ )
+#   if defined( __linux__ ) && defined( __ia64__ )
+	((ucontext_t *)(context))->uc_mcontext.sc_gr[13] = THREAD_GETMEM( threadPointer );
+#   else
+	#error uC++ : internal error, unsupported architecture
+#   endif
+#endif // __U_MULTI__ && __U_SWAPCONTEXT__
+
+    uSwitch( coroutine.context, context );		// context switch to task
+
+    activeProcessorKernel->handoffDone();		// complete direct handoff to this task
+    coroutine.restore();				// restore user specified contexts
+
+#if ! defined( __U_ERRNO_FUNC__ )
+    *my_errno_location() = coroutine.errno_;		// restore
+#endif // ! __U_ERRNO_FUNC__
+
+    coroutine.setState( Active );			// set state of new coroutine to active
+    currTask.setState( uBaseTask::Running );
+
+#ifdef __U_PROFILER__
+    if ( currTask.profileActive && uProfiler::uProfiler_builtinRegisterTaskUnblock ) { // uninterruptable hooks
+	(*uProfiler::uProfiler_builtinRegisterTaskUnblock)( uProfiler::profilerInstance, currTask );
+    } // if
+#endif // __U_PROFILER__
+} // uBaseCoroutine::taskSw
+
+
 void uBaseCoroutine::contextSw2() {			// switch between two coroutine contexts
     uBaseCoroutine &coroutine = uThisCoroutine();	// optimization
     uBaseTask &currTask = uThisTask();
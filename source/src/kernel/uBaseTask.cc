@@ -35,6 +35,8 @@
 #endif // __U_PROFILER__
 //#include <uDebug.h>
 
+#include <ctime>					// clock_gettime
+
 
 using namespace UPP;
 
@@ -304,6 +306,43 @@ void uBaseTask::printCallStack() const {
 #endif // __U_PROFILER__
 
 
+//######################### uBlockingIO #########################
+
+
+static unsigned long long int nanoseconds() {
+    timespec ts;
+    ::clock_gettime( CLOCK_MONOTONIC, &ts );
+    return (unsigned long long int)ts.tv_sec * 1000000000 + ts.tv_nsec;
+} // nanoseconds
+
+
+uBlockingIO::uBlockingIO( Site &site, bool offload ) : site( site ), home( NULL ), start( 0 ) {
+    uCluster *cluster = uKernelModule::blockingIOCluster;
+  if ( ! offload || cluster == NULL ) return;		// no offloading ?
+
+    uBaseTask &task = uThisTask();			// optimization
+    if ( site.average >= SlowCall && &task.bound == NULL && task.currCluster != cluster ) { // slow, can and must migrate ?
+	home = &uBaseTask::migrate( *cluster );
+#ifdef __U_STATISTICS__
+	uFetchAdd( UPP::Statistics::blocking_io_offloads, 1 );
+#endif // __U_STATISTICS__
+    } // if
+    start = nanoseconds();				// measured in place or offloaded, so a site returns in place when fast
+} // uBlockingIO::uBlockingIO
+
+
+uBlockingIO::~uBlockingIO() {
+    int terrno = errno;					// preserve errno from system call across measurement and migration
+    if ( start != 0 ) {
+	unsigned long long int elapsed = ( nanoseconds() - start ) / 1000;
+	if ( elapsed > 1000000 ) elapsed = 1000000;	// bound the weight of one call
+	site.average = ( site.average * 7 + elapsed ) / 8; // racy update, an estimate
+    } // if
+    if ( home != NULL ) uBaseTask::migrate( *home );	// return to original cluster
+    errno = terrno;
+} // uBlockingIO::~uBlockingIO
+
+
 // Local Variables: //
 // compile-command: "make install" //
 // End: //
@@ -66,22 +66,40 @@ int Statistics::ready_queue = 0, Statistics::spins = 0, Statistics::spin_sched =
     Statistics::uSpinLocks = 0, Statistics::uLocks = 0, Statistics::uOwnerLocks = 0, Statistics::uCondLocks = 0, Statistics::uSemaphores = 0, Statistics::uSerials = 0;
 
 // I/O statistics
+#if defined( __U_EPOLL__ )
+unsigned int Statistics::epoll_waits = 0, Statistics::epoll_errors = 0, Statistics::epoll_eintr = 0;
+unsigned int Statistics::epoll_events = 0, Statistics::epoll_nothing = 0, Statistics::epoll_blocking = 0, Statistics::epoll_pending = 0;
+unsigned int Statistics::epoll_ctls = 0, Statistics::epoll_maxFD = 0;
+unsigned int &Statistics::select_syscalls = Statistics::epoll_waits, &Statistics::select_errors = Statistics::epoll_errors, &Statistics::select_eintr = Statistics::epoll_eintr;
+unsigned int &Statistics::select_events = Statistics::epoll_events, &Statistics::select_nothing = Statistics::epoll_nothing, &Statistics::select_blocking = Statistics::epoll_blocking, &Statistics::select_pending = Statistics::epoll_pending;
+unsigned int &Statistics::select_maxFD = Statistics::epoll_maxFD;
+#else
 unsigned int Statistics::select_syscalls = 0, Statistics::select_errors = 0, Statistics::select_eintr = 0;
 unsigned int Statistics::select_events = 0, Statistics::select_nothing = 0, Statistics::select_blocking = 0, Statistics::select_pending = 0;
 unsigned int Statistics::select_maxFD = 0;
+#endif // __U_EPOLL__
 unsigned int Statistics::accept_syscalls = 0, Statistics::accept_errors = 0;
 unsigned int Statistics::read_syscalls = 0, Statistics::read_errors = 0, Statistics::read_eagain = 0, Statistics::read_chunking = 0, Statistics::read_bytes = 0;
 unsigned int Statistics::write_syscalls = 0, Statistics::write_errors = 0, Statistics::write_eagain = 0, Statistics::write_bytes = 0;
 unsigned int Statistics::sendfile_syscalls = 0, Statistics::sendfile_errors = 0, Statistics::sendfile_eagain = 0, Statistics::first_sendfile = 0, Statistics::sendfile_yields = 0;
+unsigned int Statistics::splice_syscalls = 0, Statistics::splice_errors = 0, Statistics::splice_eagain = 0, Statistics::splice_bytes = 0;
+#if defined( __U_IO_URING__ )
+unsigned int Statistics::uring_operations = 0, Statistics::uring_submits = 0, Statistics::uring_completions = 0;
+#endif // __U_IO_URING__
 
 unsigned int Statistics::iopoller_exchange = 0, Statistics::iopoller_spin = 0;
+unsigned int Statistics::blocking_io_offloads = 0;
 unsigned int Statistics::signal_alarm = 0, Statistics::signal_usr1 = 0;
 
 // Scheduling statistics
 unsigned int Statistics::roll_forward = 0;
 unsigned int Statistics::user_context_switches = 0;
+unsigned int Statistics::handoff_switches = 0;
 unsigned int Statistics::kernel_thread_yields = 0, Statistics::kernel_thread_pause = 0;
 unsigned int Statistics::wake_processor = 0;
+unsigned int Statistics::spin_hits = 0, Statistics::spin_misses = 0, Statistics::spin_budget_max = 0;
+unsigned long long int Statistics::spin_budget_total = 0;
+unsigned int Statistics::stack_cache_hits = 0, Statistics::stack_cache_misses = 0, Statistics::stack_cache_trims = 0;
 unsigned int Statistics::events = 0, Statistics::setitimer = 0;
 
 // Print statistics
@@ -122,6 +140,18 @@ void UPP::Statistics::print() {
 
     len = snprintf( helpText, 512,
 		    "\nI/O statistics:\n"
+#if defined( __U_EPOLL__ )
+		    "  epoll:"
+		    " waits %d"
+		    " / errors %d"
+		    " (EINTR %d)"
+		    " / events %d"
+		    " / no events %d"
+		    " / events per wait %d"
+		    " / blocking %d"
+		    " / registrations %d"
+		    " / max fd %d\n"
+#else
 		    "  select:"
 		    " calls %d"
 		    " / errors %d"
@@ -131,9 +161,21 @@ void UPP::Statistics::print() {
 		    " / events per call %d"
 		    " / blocking %d"
 		    " / max fd %d\n"
+#endif // __U_EPOLL__
 		    "  accept:"
 		    " calls %d"
 		    " / errors %d\n",
+#if defined( __U_EPOLL__ )
+		    Statistics::epoll_waits,
+		    Statistics::epoll_errors,
+		    Statistics::epoll_eintr,
+		    Statistics::epoll_events,
+		    Statistics::epoll_nothing,
+		    (Statistics::epoll_waits != 0 ? Statistics::epoll_events / Statistics::epoll_waits : 0 ),
+		    Statistics::epoll_blocking,
+		    Statistics::epoll_ctls,
+		    Statistics::epoll_maxFD,
+#else
 		    Statistics::select_syscalls,
 		    Statistics::select_errors,
 		    Statistics::select_eintr,
@@ -142,6 +184,7 @@ void UPP::Statistics::print() {
 		    (Statistics::select_syscalls != 0 ? Statistics::select_events / Statistics::select_syscalls : 0 ),
 		    Statistics::select_blocking,
 		    Statistics::select_maxFD,
+#endif // __U_EPOLL__
 		    Statistics::accept_syscalls,
 		    Statistics::accept_errors );
     uDebugWrite( STDOUT_FILENO, helpText, len );
@@ -176,32 +219,70 @@ void UPP::Statistics::print() {
 		    " / eagain %d"
 		    " / yields %d"
 		    " / first call completion %d\n"
+		    "  splice:"
+		    " calls %d"
+		    " / errors %d"
+		    " / eagain %d"
+		    " / bytes %d\n"
 		    "  iopoller:"
 		    " exchanges %d"
-		    " / spins %d\n",
+		    " / spins %d\n"
+		    "  blocking I/O: offloads %d\n",
 		    Statistics::sendfile_syscalls,
 		    Statistics::sendfile_errors,
 		    Statistics::sendfile_eagain,
 		    Statistics::sendfile_yields,
 		    Statistics::first_sendfile,
+		    Statistics::splice_syscalls,
+		    Statistics::splice_errors,
+		    Statistics::splice_eagain,
+		    Statistics::splice_bytes,
 		    Statistics::iopoller_exchange,
-		    Statistics::iopoller_spin );
+		    Statistics::iopoller_spin,
+		    Statistics::blocking_io_offloads );
     uDebugWrite( STDOUT_FILENO, helpText, len );
 
+#if defined( __U_IO_URING__ )
+    len = snprintf( helpText, 512,
+		    "  io_uring:"
+		    " operations %d"
+		    " / submits %d"
+		    " / completions %d\n",
+		    Statistics::uring_operations,
+		    Statistics::uring_submits,
+		    Statistics::uring_completions );
+    uDebugWrite( STDOUT_FILENO, helpText, len );
+#endif // __U_IO_URING__
+
     len = snprintf( helpText, 512,
 		    "\nScheduler statistics:\n"
 		    "  roll forward: %d\n"
-		    "  user context switches: %d\n"
+		    "  user context switches: %d"
+		    " / direct handoffs %d\n"
 		    "  kernel thread: yields %d"
 		    " / pause %d"
 		    " / processor wake %d\n"
+		    "  idle spin: hits %d"
+		    " / misses %d"
+		    " / budget avg %llu / max %d ns\n"
+		    "  stack cache: hits %d"
+		    " / misses %d"
+		    " / trimmed %d\n"
 		    "  events %d"
 		    " / setitimer %d\n",
 		    Statistics::roll_forward,
 		    Statistics::user_context_switches,
+		    Statistics::handoff_switches,
 		    Statistics::kernel_thread_yields,
 		    Statistics::kernel_thread_pause,
 		    Statistics::wake_processor,
+		    Statistics::spin_hits,
+		    Statistics::spin_misses,
+		    Statistics::spin_hits + Statistics::spin_misses != 0 ? Statistics::spin_budget_total / ( Statistics::spin_hits + Statistics::spin_misses ) : 0,
+		    Statistics::spin_budget_max,
+		    Statistics::stack_cache_hits,
+		    Statistics::stack_cache_misses,
+		    Statistics::stack_cache_trims,
 		    Statistics::events,
 		    Statistics::setitimer );
     uDebugWrite( STDOUT_FILENO, helpText, len );
@@ -230,6 +311,9 @@ uSystemTask *uKernelModule::systemTask = NULL;
 uCluster *uKernelModule::userCluster = NULL;
 uProcessor **uKernelModule::userProcessors = NULL;
 unsigned int uKernelModule::numUserProcessors = 0;
+uCluster *uKernelModule::blockingIOCluster = NULL;
+uProcessor **uKernelModule::blockingIOProcessors = NULL;
+unsigned int uKernelModule::numBlockingIOProcessors = 0;
 
 unsigned int uKernelModule::attaching = 0; // debugging
 
@@ -250,9 +334,9 @@ int uKernelModule::retCode = 0;
 
 size_t uMachContext::pageSize = 0;
 
-#ifdef __U_FLOATINGPOINTDATASIZE__
+#if defined( __U_FLOATINGPOINTDATASIZE__ ) || defined( __U_FLOATINGPOINTCONTROL__ )
 int uFloatingPointContext::uniqueKey = 0;
-#endif // __U_FLOATINGPOINTDATASIZE__
+#endif // __U_FLOATINGPOINTDATASIZE__ || __U_FLOATINGPOINTCONTROL__
 
 bool uHeapControl::traceHeap_ = false;
 
@@ -845,6 +929,14 @@ bool uBaseScheduleFriend::checkHookConditions( uBaseTask &task1, uBaseTask &task
     return task2.getSerial().checkHookConditions( &task1 );
 } // uBaseScheduleFriend::checkHookConditions
 
+unsigned int uBaseScheduleFriend::getReadyQueueIndex( uProcessor &processor ) const {
+    return processor.readyQueueIndex;
+} // uBaseScheduleFriend::getReadyQueueIndex
+
+void uBaseScheduleFriend::setReadyQueueIndex( uProcessor &processor, unsigned int index ) {
+    processor.readyQueueIndex = index;
+} // uBaseScheduleFriend::setReadyQueueIndex
+
 
 //######################### uBasePrioritySeq #########################
 
@@ -1097,6 +1189,10 @@ void uKernelModule::rollForward( bool inKernel ) {
     uFetchAdd( UPP::Statistics::roll_forward, 1 );
 #endif // __U_STATISTICS__
 
+#if defined( __U_PROCESSOR_TIMERS__ )
+    uEventNode *event;					// each processor processes its own event list
+    for ( uEventListPop iter( *uThisProcessor().events, inKernel ); iter >> event; );
+#else
 #if defined( __U_MULTI__ )
     if ( &uThisProcessor() == uKernelModule::systemProcessor ) { // process events on event list
 #endif // __U_MULTI__
@@ -1111,6 +1207,7 @@ void uKernelModule::rollForward( bool inKernel ) {
 	} // if
     } // if
 #endif // __U_MULTI__
+#endif // __U_PROCESSOR_TIMERS__
 
 #ifdef __U_DEBUG_H__
     uDebugPrtBuf( buffer, "rollForward, leaving, RFinprogress:%d\n", THREAD_GETMEM( RFinprogress ) );
@@ -1478,10 +1575,10 @@ namespace UPP {
 		mutexOwner = &(acceptSignalled.drop()->task()); // next task to gain control of the mutex object
 		if ( checkHookConditions( &task ) ) entryList.onRelease( task );
 		if ( checkHookConditions( mutexOwner ) ) entryList.onAcquire( *mutexOwner );
-		uProcessorKernel::schedule( &spinLock, mutexOwner ); // find someone else to execute; release lock and wake on kernel stack
+		uProcessorKernel::handoff( &spinLock, mutexOwner ); // switch to signalled/acceptor task; release lock on its stack
 	    } else {
 		mutexOwner = &(acceptSignalled.drop()->task()); // next task to gain control of the mutex object
-		uProcessorKernel::schedule( mutexOwner ); // find someone else to execute; wake on kernel stack
+		uProcessorKernel::handoff( mutexOwner ); // switch to signalled/acceptor task
 	    } // if
 	} // if
 #ifdef __U_DEBUG_H__
@@ -1562,7 +1659,7 @@ namespace UPP {
 		    if ( checkHookConditions( &task ) ) entryList.onRelease( task );  
 		    // do not call the acquire hook for the destructor
 		} // if
-		uProcessorKernel::schedule( &spinLock, mutexOwner ); // find someone else to execute; release lock and wake on kernel stack
+		uProcessorKernel::handoff( &spinLock, mutexOwner ); // switch to accepted task; release lock on its stack
 		if ( task.acceptedCall ) {		// accepted entry is suspended if true
 		    task.acceptedCall->acceptorSuspended = false; // acceptor resumes
 		    task.acceptedCall = NULL;
@@ -1585,7 +1682,7 @@ namespace UPP {
 		    if ( checkHookConditions( &task ) ) entryList.onRelease( task );  
 		    if ( checkHookConditions( mutexOwner ) ) entryList.onAcquire( *mutexOwner );
 		} // if
-		uProcessorKernel::schedule( &spinLock, mutexOwner ); // find someone else to execute; release lock and wake on kernel stack
+		uProcessorKernel::handoff( &spinLock, mutexOwner ); // switch to accepted task; release lock on its stack
 		if ( task.acceptedCall ) {		// accepted entry is suspended if true
 		    task.acceptedCall->acceptorSuspended = false; // acceptor resumes
 		    task.acceptedCall = NULL;
@@ -2270,7 +2367,9 @@ void UPP::uKernelBoot::startup() {
     uCluster::NBIO = new uNBIO;
 #endif // ! __U_MULTI__
 
+#if ! defined( __U_PROCESSOR_TIMERS__ )
     uProcessor::events = new uEventList;
+#endif // ! __U_PROCESSOR_TIMERS__
 
     // create system cluster: it is at a fixed address so storing the result is unnecessary.
 
@@ -2466,7 +2565,9 @@ void UPP::uKernelBoot::finishup() {
     delete uProcessor::contextSwitchHandler;
 #endif // ! __U_MULTI__
 
+#if ! defined( __U_PROCESSOR_TIMERS__ )
     delete uProcessor::events;
+#endif // ! __U_PROCESSOR_TIMERS__
 
     // remove processor kernal coroutine with execution still pending
     delete THREAD_GETMEM( processorKernelStorage );
@@ -2510,10 +2611,36 @@ void uInitProcessorsBoot::startup() {
     for ( unsigned int i = 1; i < uKernelModule::numUserProcessors; i += 1 ) {
 	uKernelModule::userProcessors[i] = new uProcessor( *uKernelModule::userCluster );
     } // for
+
+#ifdef __U_MULTI__
+    // create blocking I/O cluster and processors, which execute system calls that block the kernel thread
+
+    uKernelModule::numBlockingIOProcessors = uDefaultBlockingIOProcessors();
+    if ( uKernelModule::numBlockingIOProcessors != 0 ) {
+	uCluster *cluster = new uCluster( "blockingIOCluster" );
+	uKernelModule::blockingIOProcessors = new uProcessor*[ uKernelModule::numBlockingIOProcessors ];
+	for ( unsigned int i = 0; i < uKernelModule::numBlockingIOProcessors; i += 1 ) {
+	    uKernelModule::blockingIOProcessors[i] = new uProcessor( *cluster );
+	} // for
+	uKernelModule::blockingIOCluster = cluster;	// offloading starts once the processors exist
+    } // if
+#endif // __U_MULTI__
 } // uInitProcessorsBoot::startup
 
 
 void uInitProcessorsBoot::finishup() {
+#ifdef __U_MULTI__
+    if ( uKernelModule::blockingIOCluster != NULL ) {
+	uCluster *cluster = uKernelModule::blockingIOCluster;
+	uKernelModule::blockingIOCluster = NULL;	// later system calls block in place
+	for ( unsigned int i = 0; i < uKernelModule::numBlockingIOProcessors; i += 1 ) {
+	    delete uKernelModule::blockingIOProcessors[i];
+	} // for
+	delete [] uKernelModule::blockingIOProcessors;
+	delete cluster;
+    } // if
+#endif // __U_MULTI__
+
     for ( unsigned int i = 1; i < uKernelModule::numUserProcessors; i += 1 ) {
 	delete uKernelModule::userProcessors[i];
     } // for
@@ -108,6 +108,32 @@
     #error uC++ : internal error, unsupported architecture
 #endif
 
+// Epoll and io_uring are used where supported and can be turned off by defining __U_NO_EPOLL__ or __U_NO_IO_URING__
+// when compiling the runtime and the application, e.g., -D__U_NO_EPOLL__ restores the pselect implementation of
+// non-blocking I/O. Eventfd parking, processor timers, tickless time slicing and processor I/O pollers are modes, off
+// by default and selected by defining their macros the same way, e.g., -D__U_EVENTFD_PARK__; a mode is ignored where
+// it is not supported, and __U_NO_PROCESSOR_POLLERS__ overrides __U_PROCESSOR_POLLERS__.
+
+#if defined( __linux__ ) && ! defined( __U_NO_EPOLL__ )
+#    define __U_EPOLL__					// non-blocking I/O waits on an edge-triggered epoll set rather than pselect
+#endif // __linux__ && ! __U_NO_EPOLL__
+
+#if ! defined( __U_MULTI__ ) || ! defined( __linux__ )	// modes need kernel threads on Linux
+#    undef __U_EVENTFD_PARK__				// idle processors block on an eventfd rather than sigsuspend
+#    undef __U_PROCESSOR_TIMERS__			// per-processor event list and POSIX timer rather than ITIMER_REAL
+#    undef __U_TICKLESS__				// time-slice event armed only when tasks compete for processors
+#endif // ! __U_MULTI__ || ! __linux__
+
+#if defined( __U_EPOLL__ ) && defined( __U_EVENTFD_PARK__ ) && ! defined( __U_NO_IO_URING__ ) && defined( __has_include ) // completions wake a processor parked in ppoll
+#    if __has_include( <linux/io_uring.h> )
+#        define __U_IO_URING__				// disk I/O submitted through a per-cluster io_uring
+#    endif
+#endif
+
+#if ! defined( __U_EPOLL__ ) || ! defined( __U_EVENTFD_PARK__ ) || defined( __U_NO_PROCESSOR_POLLERS__ ) // a parked processor watches the epoll sets
+#    undef __U_PROCESSOR_POLLERS__			// processors poll descriptors from the scheduler loop rather than a poller task
+#endif
+
 #include <uStaticAssert.h>				// access: _STATIC_ASSERT_
 #include <assert.h>
 //#include <uDebug.h>
@@ -138,11 +164,15 @@
 
 // C-heap allocation extensions
 extern "C" void *cmemalign( size_t alignment, size_t noOfElems, size_t elemSize ) __THROW;
+extern "C" void free_sized( void *addr, size_t size ) __THROW;
+extern "C" void free_aligned_sized( void *addr, size_t alignment, size_t size ) __THROW;
 extern "C" size_t malloc_alignment( void *addr ) __THROW;
 extern "C" bool malloc_zero_fill( void *addr ) __THROW;
 extern "C" size_t malloc_usable_size( void *addr ) __THROW;
 extern "C" void malloc_stats() __THROW;
 extern "C" int malloc_stats_fd( int fd ) __THROW;
+extern "C" void malloc_profile() __THROW;
+extern "C" int malloc_profile_fd( int fd ) __THROW;
 
 #include <exception>
 #include <iosfwd>					// std::filebuf
@@ -162,6 +192,13 @@ extern "C" int malloc_stats_fd( int fd ) __THROW;
 #ifndef M_TOP_PAD
 #define M_TOP_PAD (-2)
 #endif // M_TOP_PAD
+#ifndef M_TRIM_THRESHOLD
+#define M_TRIM_THRESHOLD (-3)
+#endif // M_TRIM_THRESHOLD
+#define M_TRIM_INTERVAL (-101)				// uC++ specific, milliseconds between background trims
+#define M_HUGE_PAGES (-102)				// uC++ specific, 0 => none, 1 => transparent, 2 => MAP_HUGETLB
+#define M_NUMA_ARENAS (-103)				// uC++ specific, 0 => single heap, 1 => arena per NUMA node
+#define M_HEAP_SAMPLE (-104)				// uC++ specific, heap-profile sampling rate in bytes, 0 => none
 
 
 #ifdef __U_STATISTICS__
@@ -172,22 +209,40 @@ namespace UPP {
 	static int uSpinLocks, uLocks, uOwnerLocks, uCondLocks, uSemaphores, uSerials;
 
 	// I/O statistics
+#if defined( __U_EPOLL__ )
+	static unsigned int epoll_waits, epoll_errors, epoll_eintr;
+	static unsigned int epoll_events, epoll_nothing, epoll_blocking, epoll_pending;
+	static unsigned int epoll_ctls, epoll_maxFD;
+	// select names for the corresponding epoll counters
+	static unsigned int &select_syscalls, &select_errors, &select_eintr;
+	static unsigned int &select_events, &select_nothing, &select_blocking, &select_pending;
+	static unsigned int &select_maxFD;
+#else
 	static unsigned int select_syscalls, select_errors, select_eintr;
 	static unsigned int select_events, select_nothing, select_blocking, select_pending;
 	static unsigned int select_maxFD;
+#endif // __U_EPOLL__
 	static unsigned int accept_syscalls, accept_errors;
 	static unsigned int read_syscalls, read_errors, read_eagain, read_chunking, read_bytes;
 	static unsigned int write_syscalls, write_errors, write_eagain, write_bytes;
 	static unsigned int sendfile_syscalls, sendfile_errors, sendfile_eagain, first_sendfile, sendfile_yields;
+	static unsigned int splice_syscalls, splice_errors, splice_eagain, splice_bytes;
+#if defined( __U_IO_URING__ )
+	static unsigned int uring_operations, uring_submits, uring_completions;
+#endif // __U_IO_URING__
 
 	static unsigned int iopoller_exchange, iopoller_spin;
+	static unsigned int blocking_io_offloads;
 	static unsigned int signal_alarm, signal_usr1;
 
 	// Scheduling statistics
 	static unsigned int roll_forward;
-	static unsigned int user_context_switches;
+	static unsigned int user_context_switches, handoff_switches;
 	static unsigned int kernel_thread_yields, kernel_thread_pause;
 	static unsigned int wake_processor;
+	static unsigned int spin_hits, spin_misses, spin_budget_max;
+	static unsigned long long int spin_budget_total;
+	static unsigned int stack_cache_hits, stack_cache_misses, stack_cache_trims;
 	static unsigned int events, setitimer;
 
 	static bool prtSigterm;
@@ -231,6 +286,9 @@ _Task uPthreadable;					// forward declaration
 class HWCounters;					// forward declaration
 _Task uLocalDebugger;					// forward declaration
 class uIOClosure;					// forward declaration
+#if defined( __U_EPOLL__ )
+struct epoll_event;					// forward declaration
+#endif // __U_EPOLL__
 class uCondition;					// forward declaration
 class uTimeoutHndlr;					// forward declaration
 class uWakeupHndlr;					// forward declaration
@@ -239,6 +297,7 @@ class uRWLock;						// forward declaration
 namespace UPP {
     class uKernelBoot;					// forward declaration
     class uInitProcessorsBoot;				// forward declaration
+    class uBlockingIO;					// forward declaration
     _Task uBootTask;					// forward declaration
     class uHeapManager;					// forward declaration
     class uHeapControl;					// forward declaration
@@ -256,6 +315,7 @@ namespace UPP {
     class PthreadLock;					// forward declaration
     _Coroutine uProcessorKernel;			// forward declaration
     class uNBIO;					// forward declaration
+    class uIOuring;					// forward declaration
     void umainProfile();				// forward declaration
 } // UPP
 
@@ -305,17 +365,22 @@ namespace UPP {
     class uSigHandlerModule {
 	friend class uKernelBoot;			// access: uSigHandlerModule
 	friend _Task ::uLocalDebugger;			// access: signal
+	friend class uHeapManager;			// access: heapProfileSignal
 #ifdef __U_PROFILER__
 	friend _Task ::uProfiler;			// access: signal, signalContextPC
 #endif // __U_PROFILER__
 
 	static sigset_t block_mask;			// block all signals
+	static struct sigaction heapProfilePrev;	// SIGUSR2 disposition replaced while sampling the heap
+	static bool heapProfileInstalled;		// SIGUSR2 requests heap-profile dumps
 
 	static void signal( int sig, void (*handler)(__U_SIGPARMS__), int flags = 0 );
 	static void *signalContextPC( __U_SIGCXT__ cxt );
 	static void *functionAddress( void (*function)() );
 	static void sigTermHandler( __U_SIGPARMS__ );
 	static void sigAlrmHandler( __U_SIGPARMS__ );
+	static void sigHeapProfileHandler( __U_SIGPARMS__ );
+	static void heapProfileSignal( bool on );
 	static void sigSegvBusHandler( __U_SIGPARMS__ );
 	static void sigIllHandler( __U_SIGPARMS__ );
 	static void sigFpeHandler( __U_SIGPARMS__ );
@@ -435,7 +500,8 @@ class uKernelModule {
     friend _Task uSystemTask;				// access: systemCluster
     friend void UPP::umainProfile();			// access: bootTask
     friend class UPP::uKernelBoot;			// access: everything
-    friend class UPP::uInitProcessorsBoot;		// access: numUserProcessors, userProcessors
+    friend class UPP::uInitProcessorsBoot;		// access: numUserProcessors, userProcessors, blockingIOCluster, blockingIOProcessors
+    friend class UPP::uBlockingIO;			// access: blockingIOCluster
     friend class UPP::uHeapManager;			// access: bootTaskStorage, kernelModuleInitialized, startup
     friend class UPP::uNBIO;				// access: uKernelModuleBoot
     friend int pthread_mutex_lock( pthread_mutex_t *mutex ) __THROW; // access: kernelModuleInitialized
@@ -608,6 +674,9 @@ class uKernelModule {
     static char systemClusterStorage[];
     static uCluster *systemCluster;			// pointer to system cluster
     static uCluster *userCluster;			// pointer to user cluster
+    static uProcessor **blockingIOProcessors;		// pointer to blocking I/O processors
+    static unsigned int numBlockingIOProcessors;	// number of blocking I/O processors
+    static uCluster *blockingIOCluster;			// pointer to blocking I/O cluster, 0 => no offloading
     static char bootTaskStorage[];
 
     static std::filebuf *cerrFilebuf, *clogFilebuf, *coutFilebuf, *cinFilebuf;
@@ -1050,10 +1119,10 @@ typedef uSequence<uContext> uContextSeq;
 // class in the same way that a user can extend the amount of context that is saved and restored with a coroutine or
 // task.
 
-#if defined( __i386__ )
-// saved by caller
-#elif defined( __x86_64__ )
-// saved by caller
+#if defined( __i386__ ) || defined( __x86_64__ )
+// Registers are saved by caller, but the x87 control word and SSE control/status register are callee saved, so only
+// these are saved; they are reloaded only if another execution state changed them (loading them is expensive).
+#define __U_FLOATINGPOINTCONTROL__
 #elif defined( __ia64__ )
 #if ! defined( __U_SWAPCONTEXT__ )
 #define __U_FLOATINGPOINTDATASIZE__ 40			// 20 16-byte registers
@@ -1068,16 +1137,21 @@ typedef uSequence<uContext> uContextSeq;
 // Some architectures store the floating point registers with the integers registers during a basic context switch, so
 // there is no need for a data area to storage the floating point registers.
 
-#ifdef __U_FLOATINGPOINTDATASIZE__
+#if defined( __U_FLOATINGPOINTDATASIZE__ ) || defined( __U_FLOATINGPOINTCONTROL__ )
 class uFloatingPointContext : public uContext {
     static int uniqueKey;
+#ifdef __U_FLOATINGPOINTDATASIZE__
     double floatingPointData[__U_FLOATINGPOINTDATASIZE__] __attribute__(( aligned(16) ));
+#else
+    unsigned int mxcsr;					// SSE control/status register
+    unsigned short int fpucw;				// x87 control word
+#endif // __U_FLOATINGPOINTDATASIZE__
   public:
     uFloatingPointContext();
 #else
 class uFloatingPointContext {
   public:
-#endif // __U_FLOATINGPOINTDATASIZE__
+#endif // __U_FLOATINGPOINTDATASIZE__ || __U_FLOATINGPOINTCONTROL__
     void save();					// save and restore the floating point context
     void restore();
 } __attribute__(( unused )); // uFloatingPointContext
@@ -1108,6 +1182,7 @@ namespace UPP {
 	friend _Coroutine uProcessorKernel;		// access: storage
 	friend class ::uProcessor;			// access: storage
 	friend class uKernelBoot;			// access: storage
+	friend class ::uCluster;			// access: stackGuard, stackMmap, releaseStorage, freeStorage
 	friend void *uKernelModule::startThread( void *p ); // acesss: invokeCoroutine
 
 	struct uContext_t {
@@ -1138,6 +1213,11 @@ namespace UPP {
 	bool userStack;					// use specified stack storage ?
 
 	void createContext( unsigned int stackSize );	// used by all constructors
+	static bool stackMmap( unsigned int size );	// stack reserved with mmap ?
+	static size_t stackGuard( unsigned int size );	// size of guard page at start of storage
+	static size_t stackExtent( unsigned int size );	// size of mmap reservation
+	static void releaseStorage( void *storage, unsigned int size ); // return untouched pages of cached stack
+	static void freeStorage( void *storage, unsigned int size ); // release stack storage not cached
 
 	void startHere( void (*uInvoke)( uMachContext & ) );
 
@@ -1154,8 +1234,9 @@ namespace UPP {
 	void extraRestore();
 
 	void save() {
-	    // Any extra work that must occur on this side of a context switch is performed here.
-	    if ( extras.allExtras ) {
+	    // Any extra work that must occur on this side of a context switch is performed here. Most execution states
+	    // have no additional contexts, so the test is predicted false.
+	    if ( __builtin_expect( extras.allExtras != 0, false ) ) {
 		extraSave();
 	    } // if
 
@@ -1170,7 +1251,7 @@ namespace UPP {
 #endif // __U_DEBUG__
 
 	    // Any extra work that must occur on this side of a context switch is performed here.
-	    if ( extras.allExtras ) {
+	    if ( __builtin_expect( extras.allExtras != 0, false ) ) {
 		extraRestore();
 	    } // if
 	} // uMachContext::restore
@@ -1189,16 +1270,7 @@ namespace UPP {
 	    createContext( storageSize );
 	} // uMachContext::uMachContext
 
-	virtual ~uMachContext() {
-	    if ( ! userStack ) {
-#ifdef __U_DEBUG__
-		if ( ::mprotect( storage, pageSize, PROT_READ | PROT_WRITE ) == -1 ) {
-		    uAbort( "(uMachContext &)%p.~uMachContext() : internal error, mprotect failure, error(%d) %s.", this, errno, strerror( errno ) );
-		} // if
-#endif // __U_DEBUG__
-		free( storage );
-	    } // if
-	} // uMachContext::~uMachContext
+	virtual ~uMachContext();
 
 	void *stackPointer() const;
 #if defined( __ia64__ )
@@ -1241,7 +1313,7 @@ class uBaseCoroutine : public UPP::uMachContext {
     friend class UPP::uTaskConstructor;			// access: name, serial
     friend class UPP::uKernelBoot;			// access: last
     friend _Task UPP::uBootTask;			// access: notHalted
-    friend _Coroutine UPP::uProcessorKernel;		// access: contextSw
+    friend _Coroutine UPP::uProcessorKernel;		// access: contextSw, taskSw
 #ifdef __U_ERRNO_FUNC__
     friend int *__U_ERRNO_FUNC__ __THROW;		// access: errno_
 #endif // __U_ERRNO_FUNC__
@@ -1345,6 +1417,7 @@ class uBaseCoroutine : public UPP::uMachContext {
 
     void contextSw();					// switch between a task and the kernel
     void contextSw2();					// switch between two coroutine contexts
+    void taskSw( uBaseTask &task );			// switch directly between two tasks
 
     void corStarter() {					// remembers who started a coroutine
 	starter_ = last;
@@ -1505,6 +1578,8 @@ class uBaseScheduleFriend {
     int setBaseQueue( uBaseTask &task, int priority );
     bool isEntryBlocked( uBaseTask &task ) const;
     bool checkHookConditions( uBaseTask &task1, uBaseTask &task2 ) const;
+    unsigned int getReadyQueueIndex( uProcessor &processor ) const;
+    void setReadyQueueIndex( uProcessor &processor, unsigned int index );
 }; // uBaseScheduleFriend
 
 
@@ -1520,6 +1595,12 @@ template<typename Node> class uBaseSchedule : protected uBaseScheduleFriend {
     virtual void addInitialize( uBaseTaskSeq &taskList ) = 0;
     virtual void removeInitialize( uBaseTaskSeq &taskList ) = 0;
     virtual void rescheduleTask( uBaseTaskDL *taskNode, uBaseTaskSeq &taskList ) = 0;
+
+    // A scheduler with per-processor ready queues does its own locking, so the cluster does not serialize add/drop
+    // with its ready/idle lock, and it is told when processors join or leave the cluster.
+    virtual bool internalLocking() const { return false; }
+    virtual void processorAdd( uProcessor &processor ) {}
+    virtual void processorRemove( uProcessor &processor ) {}
 }; // uBaseSchedule
 
 
@@ -2033,6 +2114,7 @@ class uBaseTask : public uBaseCoroutine {
     friend class uEventList;				// access: profileActive
     friend class UPP::uHeapControl;			// access: heapData
     friend class uEventListPop;				// access: currCluster
+    friend class UPP::uBlockingIO;			// access: currCluster, bound
 #ifdef KNOT
     friend int pthread_mutex_lock( pthread_mutex_t *mutex ) __THROW; // access: setActivePriority
     friend int pthread_mutex_trylock( pthread_mutex_t *mutex ) __THROW; // access: setActivePriority
@@ -2255,7 +2337,7 @@ class uBaseTask : public uBaseCoroutine {
 
     uBasePIQ *uPIQ;					// TEMPORARY
     void *pthreadData;					// pointer to pthread specific data
-    void *heapData;					// thread-local storage for per-thread heaps
+    void *heapData;					// regions bound to the task (see uRegion)
 
     void uYieldNoPoll();
     void uYieldYield( unsigned int times );		// inserted by translator for -yield
@@ -2379,8 +2461,8 @@ namespace UPP {
 #else
     class uNBIO {					// monitor (private mutex member)
 #endif
-	friend class ::uCluster;			// access: NBIO
-	friend _Coroutine uProcessorKernel;		// access: okToSelect, IOPoller
+	friend class ::uCluster;			// access: NBIO, registerFD, pending, epollFd, watcher
+	friend _Coroutine uProcessorKernel;		// access: okToSelect, IOPoller, poll, PollCycles, shardCounter
 	friend class uSelectTimeoutHndlr;		// access: NBIOnode
 	friend class uKernelBoot;			// access: uNBIO
 
@@ -2416,6 +2498,73 @@ namespace UPP {
 	    void handler();
 	}; // uSelectTimeoutHndlr
 
+#if defined( __U_EPOLL__ )
+	// Each descriptor is added once to an epoll set of the cluster, edge-triggered for all events, and the
+	// registration is remembered in the descriptor's uPoll. An edge arriving while no task waits is remembered in
+	// "ready", so a task registering after the edge retries its operation rather than waiting for an edge that never
+	// comes.
+
+	enum { EventsPerWait = 256,			// maximum events returned by one epoll_wait
+	       FdChunk = 1024,				// descriptors per chunk of the descriptor table
+	       FdChunks = 16,				// initial chunks in the descriptor table, doubled as needed
+	       ExpiredMax = 64 };			// single-fd timeouts remembered before scanning all waiting fds
+
+	struct FdState : public uSeqable {
+	    uSequence<NBIOnode> waiting;		// tasks waiting for an I/O event on this fd
+	    int ready;					// edges not consumed by an operation (ReadSelect/WriteSelect/ExceptSelect)
+	    unsigned int edges;				// events seen, detects an edge arriving during a failed operation
+
+	    FdState() : ready( 0 ), edges( 0 ) {}
+	}; // FdState
+
+	struct FdTable {
+	    unsigned int size;				// number of chunks
+	    FdState **chunks;				// chunks of FdChunk states, NULL until a descriptor in the chunk is used
+	    FdTable *prev;				// smaller table replaced by this one, kept for tasks still reading it
+
+	    FdTable( unsigned int size ) : size( size ), chunks( new FdState *[size] ), prev( NULL ) {
+		for ( unsigned int i = 0; i < size; i += 1 ) chunks[i] = NULL;
+	    } // FdTable::FdTable
+
+	    ~FdTable() { delete [] chunks; }
+	}; // FdTable
+
+	int epollFd;					// epoll set for all descriptors waited on by this cluster
+	FdTable *volatile fdTable;			// descriptor table indexed by fd, grown and chunks allocated on demand
+	uSpinLock fdTableLock;				// mutual exclusion for growing fdTable and allocating its chunks
+	uSequence<NBIOnode> pendingIOMfds;		// list of tasks waiting for an I/O event on a general FD mask
+#if defined( __U_PROCESSOR_POLLERS__ )
+	// There is no poller task. Descriptors are sharded by number across epoll sets, each with a spin lock protecting
+	// the waiting tasks of its descriptors, and the processors of the cluster poll the sets from the scheduler loop,
+	// waking tasks whose descriptors have events. A woken task performs its own I/O. The shard sets are themselves in
+	// epollFd, which one paused processor watches while tasks wait for I/O.
+
+	enum { Shards = 16,				// epoll sets per cluster
+	       EventsPerPoll = 64,			// maximum events taken from a shard by one poll
+	       PollCycles = 32 };			// scheduler passes between polls by a busy processor
+
+	struct Shard {
+	    uSpinLock lock;				// mutual exclusion for the fd states of this shard
+	    int epollFd;				// epoll set for descriptors with fd % Shards == shard
+	    volatile unsigned int waiters;		// tasks waiting on descriptors of this shard
+	}; // Shard
+
+	Shard shards[Shards];
+	uSpinLock mfdLock;				// mutual exclusion for pendingIOMfds
+	uProcessor *volatile watcher;			// paused processor watching epollFd, or 0
+	static unsigned int shardCounter;		// assigns each processor kernel a home shard
+#else
+	epoll_event *events;				// events returned by epoll_wait
+	uSequence<FdState> waitingFds;			// descriptors with waiting tasks
+
+	fd_set mrfds, mwfds, mefds;			// master copy of all multiple I/O
+	unsigned int mmaxFD;				// highest FD used in multiple master mask
+
+	uSpinLock expiredLock;				// timeout handler records single fds with timed-out tasks
+	unsigned int expired;				// number of recorded fds, > ExpiredMax => scan all waiting fds
+	int expiredFds[ExpiredMax];
+#endif // __U_PROCESSOR_POLLERS__
+#else
 	uSequence<NBIOnode> pendingIOSfds[FD_SETSIZE];	// array of lists containing tasks waiting for an I/O event on a specific FD
 	uSequence<NBIOnode> pendingIOMfds;		// list of tasks waiting for an I/O event on a general FD mask or timeout
 
@@ -2427,6 +2576,7 @@ namespace UPP {
 	unsigned int maxFD;				// highest FD used in combined master mask
 	unsigned int smaxFD;				// highest FD used in single master mask
 	unsigned int mmaxFD;				// highest FD used in multiple master mask
+#endif // __U_EPOLL__
 	int descriptors;				// declared here so uniprocessor kernel can check if I/O occurred
 	uBaseTask *IOPoller;				// pointer to current IO poller task, or 0
 	unsigned int pending;
@@ -2437,10 +2587,35 @@ namespace UPP {
 	bool okToSelect;				// uniprocessor flag indicating blocking select
 #endif // ! __U_MULTI__
 
+#if defined( __U_EPOLL__ )
+	FdState &fdState( int fd );
+	void extendFdTable( unsigned int chunk );
+	void deleteFdTable();
+	int registerFD( int fd );
+	void registerMfds( unsigned int nfds, NBIOnode &node );
+	int pollMfds( NBIOnode &node );
+#endif // __U_EPOLL__
+#if defined( __U_PROCESSOR_POLLERS__ )
+	void timeout( NBIOnode &node );
+	void pollShard( Shard &shard );
+	void poll( unsigned int home, bool idle );
+	void waitOrPoll( NBIOnode &node, uEventNode *timeoutEvent = NULL );
+	void waitOrPoll( unsigned int nfds, NBIOnode &node, uEventNode *timeoutEvent = NULL );
+#else
+#if defined( __U_EPOLL__ )
+	void addWaiter( FdState &state, NBIOnode &node );
+	void removeWaiter( FdState &state, NBIOnode *p );
+	bool attemptIO( NBIOnode &node, FdState &state, int rwe );
+	void checkSfds( int fd, NBIOnode *p, FdState &state );
+	void expireSfds( FdState &state );
+	void expire( int fd );
+	void checkMfds();
+#else
 	_Mutex void checkIOStart();
-	bool pollIO( NBIOnode &node );
 	void performIO( int fd, NBIOnode *p, uSequence<NBIOnode> &pendingIO, int cnt );
 	void checkSfds( int fd, NBIOnode *p, uSequence<NBIOnode> &pendingIO );
+#endif // __U_EPOLL__
+	bool pollIO( NBIOnode &node );
 	void unblockFD( uSequence<NBIOnode> &pendingIO );
 	_Mutex bool checkIOEnd( NBIOnode &node, int terrno );
 	bool checkPoller();
@@ -2449,10 +2624,14 @@ namespace UPP {
 	_Mutex bool initSfd( NBIOnode &node, uEventNode *timeoutEvent = NULL );
 	_Mutex bool initMfds( unsigned int nfds, NBIOnode &node, uEventNode *timeoutEvent = NULL );
 	int select( sigset_t * );
+#endif // __U_PROCESSOR_POLLERS__
 	int select( uIOClosure &closure, int &rwe, timeval *timeout = NULL );
 	int select( int nfds, fd_set *rfds, fd_set *wfds, fd_set *efds, timeval *timeout = NULL );
 
 	uNBIO();
+#if defined( __U_EPOLL__ )
+	~uNBIO();
+#endif // __U_EPOLL__
       public:
     }; // uNBIO
 } // UPP
@@ -2466,7 +2645,7 @@ template< int, int, int > class uAdaptiveLock;
 namespace UPP {
     _Coroutine uProcessorKernel {
 	friend class uKernelBoot;			// access: new, uProcessorKernel, ~uProcessorKernel
-	friend class uSerial;				// access: schedule, kernelClock
+	friend class uSerial;				// access: schedule, handoff, kernelClock
 	friend class uSerialDestructor;			// access: schedule
 	friend class ::uOwnerLock;			// access: schedule
 	template<int, int, int> friend class ::uAdaptiveLock; // access: entryRef, profileActive, wake
@@ -2477,6 +2656,7 @@ namespace UPP {
 	friend _Task ::uProcessorTask;			// access: terminated, kernelClock
 	friend class ::uProcessor;			// access: uProcessorKernel
 	friend class uNBIO;				// access: kernelClock
+	friend class ::uBaseCoroutine;			// access: handoffDone
 
 	// real-time
 
@@ -2486,6 +2666,7 @@ namespace UPP {
 	unsigned int kind;				// specific kind of schedule operation
 	uBaseSpinLock *prevLock;			// comunication
 	uBaseTask *nextTask;				// task to be wakened
+	uBaseSpinLock *handoffLock;			// lock released by task receiving a direct handoff
 
 	void taskIsBlocking();
 	static void schedule();
@@ -2496,6 +2677,16 @@ namespace UPP {
 	void scheduleInternal( uBaseSpinLock *lock );
 	void scheduleInternal( uBaseTask *task );
 	void scheduleInternal( uBaseSpinLock *lock, uBaseTask *task );
+	static void handoff( uBaseTask *task );
+	static void handoff( uBaseSpinLock *lock, uBaseTask *task );
+	bool handoffInternal( uBaseSpinLock *lock, uBaseTask *task );
+	void handoffDone() {				// called by task receiving the processor after a switch
+	    if ( handoffLock != NULL ) {		// direct handoff ?
+		uBaseSpinLock *lock = handoffLock;
+		handoffLock = NULL;
+		lock->release();			// release lock on behalf of the task that handed off
+	    } // if
+	} // uProcessorKernel::handoffDone
 	void onBehalfOfUser();
 	void setTimer( uDuration time );
 	void setTimer( uTime time );
@@ -2539,15 +2730,18 @@ inline void uBaseTask::uYieldNoPoll() {
 class uProcessor {
     friend class UPP::uKernelBoot;			// access: new, uProcessor, events, contextEvent, contextSwitchHandler, setContextSwitchEvent
     friend class uKernelModule;				// access: events
-    friend class uCluster;				// access: pid, idleRef, external, processorRef, setContextSwitchEvent
-    friend _Coroutine UPP::uProcessorKernel;		// access: events, currCluster, procTask, external, globalRef, setContextSwitchEvent
-    friend _Task uProcessorTask;			// access: pid, processorClock, preemption, currCluster, setContextSwitchEvent
+    friend class uCluster;				// access: pid, idleRef, external, processorRef, parkFD, parked, preemption, contextEvent, setContextSwitchEvent, armContextSwitchEvent
+    friend _Coroutine UPP::uProcessorKernel;		// access: events, currCluster, procTask, external, globalRef, spinExpired, spinHit, spinMiss, setContextSwitchEvent, resetContextSwitchEvent
+    friend _Task uProcessorTask;			// access: pid, processorClock, preemption, currCluster, setContextSwitchEvent, disarmContextSwitchEvent
     friend class UPP::uNBIO;				// access: setContextSwitchEvent
-    friend class uEventList;				// access: events, contextSwitchHandler
+    friend class uEventList;				// access: events, contextSwitchHandler, contextEvent, currCluster, sliceCluster
     friend class uEventNode;                            // access: events
-    friend class uEventListPop;                         // access: contextSwitchHandler
+    friend class uEventListPop;                         // access: contextSwitchHandler, competition, sliceCluster
     friend void *uKernelModule::startThread( void *p ); // acesss: everything
     friend class UPP::uMachContext;			// access: procTask
+    friend class uBaseScheduleFriend;			// access: readyQueueIndex
+    friend class UPP::uHeapManager;			// access: heapData, terminated
+    friend class UPP::uHeapControl;			// access: heapData
 #if defined( __i386__ ) || defined( __ia64__ ) && ! defined( __old_perfmon__ )
     friend class HWCounters;				// access: uPerfctrContext (i386) or uPerfmon_fd (ia64)
 #endif
@@ -2565,7 +2759,11 @@ class uProcessor {
     friend class uProfileProcessorSampler;		// access: profileProcessorSamplerInstance
 #endif // __U_PROFILER__
 
+#ifdef __U_PROCESSOR_TIMERS__
+    uEventList *events;					// list of events for this processor
+#else
     static uEventList *events;				// single list of events for all processors
+#endif // __U_PROCESSOR_TIMERS__
 #if ! defined( __U_MULTI__ )
     static						// shared info on uniprocessor
 #endif // ! __U_MULTI__
@@ -2574,6 +2772,9 @@ class uProcessor {
     static						// shared info on uniprocessor
 #endif // ! __U_MULTI__
     uCxtSwtchHndlr *contextSwitchHandler;		// special time slice handler
+#ifdef __U_TICKLESS__
+    uCluster *sliceCluster;				// cluster counting the armed time slice (see uCluster::slicesArmed)
+#endif // __U_TICKLESS__
 
 #ifdef __U_MULTI__
     UPP::uProcessorKernel processorKer;			// need a uProcessorKernel
@@ -2616,6 +2817,15 @@ class uProcessor {
     uProcessorDL idleRef;				// double link field: list of idle processors
     uProcessorDL processorRef;				// double link field: list of processors on a cluster
     uProcessorDL globalRef;				// double link field: list of all processors
+    unsigned int readyQueueIndex;			// processor's ready queue in a scheduler with per-processor queues
+    void *heapData;					// per-processor heap cache
+#ifdef __U_MULTI__
+    unsigned int spinBudget;				// adaptive idle spin time before pausing (nanoseconds), 0 => not measured
+#endif // __U_MULTI__
+#ifdef __U_EVENTFD_PARK__
+    int parkFD;						// eventfd written to wake processor when idle
+    volatile bool parked;				// processor idle and blocked on parkFD
+#endif // __U_EVENTFD_PARK__
 // TEMPORARY
     unsigned long long int startTime;
 
@@ -2623,6 +2833,18 @@ class uProcessor {
     void fork( uProcessor *processor );
     void setContextSwitchEvent( int msecs );		// set the real-time timer
     void setContextSwitchEvent( uDuration duration );	// set the real-time timer
+#ifdef __U_TICKLESS__
+    bool competition();					// tasks waiting for this processor ?
+    void resetContextSwitchEvent();			// arm time slice before running a task
+    void armContextSwitchEvent();			// arm time slice when a task becomes ready, callable from any processor
+    void disarmContextSwitchEvent();			// remove time slice and arm another on its cluster if tasks wait
+#endif // __U_TICKLESS__
+#ifdef __U_MULTI__
+    bool spinExpired( unsigned int spins, unsigned long long int spun ); // stop spinning and pause ?
+    void spinHit( unsigned long long int waited );	// adapt spin budget
+    void spinMiss( unsigned long long int paused );
+    void spinStatistics();
+#endif // __U_MULTI__
 
     uProcessor( uCluster &cluster, double );		// used solely during kernel boot
   public:
@@ -2716,17 +2938,21 @@ class uCluster {
     friend class UPP::uTaskConstructor;			// access: taskAdd
     friend class UPP::uTaskDestructor;			// access: taskRemove
     friend class UPP::uNBIO;				// access: makeProcessorIdle, makeProcessorActive
-    friend class uEventListPop;				// access: processorsOnCluster
+    friend class uEventListPop;				// access: processorsOnCluster, slicesArmed
     friend class UPP::uNBIO::uSelectTimeoutHndlr;	// access: NBIO, wakeProcessor
     friend class UPP::uKernelBoot;			// access: new, NBIO, taskAdd, taskRemove
-    friend _Coroutine UPP::uProcessorKernel;		// access: NBIO, readyQueueTryRemove, readyQueueEmpty, tasksOnCluster, makeProcessorActive, processorPause
+    friend _Coroutine UPP::uProcessorKernel;		// access: NBIO, uring, fifoReadyQueue, readyQueueTryRemove, readyQueueEmpty, tasksOnCluster, makeProcessorActive, processorPause
     friend _Task uProcessorTask;			// access: processorAdd, processorRemove
-    friend class uProcessor;				// access: processorAdd, processorRemove
+    friend class uProcessor;				// access: processorAdd, processorRemove, readyQueueEmpty, armSlice
     friend class uRealTimeBaseTask;			// access: taskReschedule
     friend class uPeriodicBaseTask;			// access: taskReschedule
     friend class uSporadicBaseTask;			// access: taskReschedule
-    friend class uIOClosure;				// access: select
+    friend class uIOClosure;				// access: select, ioUring
+#if defined( __U_IO_URING__ )
+    friend class UPP::uIOuring;				// access: readyQueueEmpty
+#endif // __U_IO_URING__
     friend class uRWLock;				// access: makeTaskReady
+    friend class UPP::uMachContext;			// access: stackCacheGet, stackCachePut
 
     // must be first field for alignment
     uSpinLock readyIdleTaskLock;			// protect readyQueue, idleProcessors and tasksOnCluster
@@ -2747,7 +2973,7 @@ class uCluster {
 
     // real-time
 
-    friend class uEventList;				// access: wakeProcessor
+    friend class uEventList;				// access: wakeProcessor, slicesArmed
     friend class uProcWakeupHndlr;			// access: wakeProcessor
 
     uClusterDL globalRef;				// double link field: list of all clusters
@@ -2762,6 +2988,8 @@ class uCluster {
     const char *name;					// textual name for cluster, default value
     uBaseSchedule<uBaseTaskDL> *readyQueue;		// list of tasks awaiting execution by processors on this cluster
     bool defaultReadyQueue;				// indicates if the cluster allocated the ready queue
+    bool selfLockingReadyQueue;				// ready queue does its own locking (per-processor queues)
+    bool fifoReadyQueue;				// ready queue is a uDefaultScheduler, so a direct handoff preserves order
     unsigned int idleProcessorsCnt;			// number of idle processors
     uProcessorSeq idleProcessors;			// list of idle processors associated with this cluster
     uBaseTaskSeq tasksOnCluster;			// list of tasks on this cluster
@@ -2771,21 +2999,46 @@ class uCluster {
 
     uClusterDL wakeupList;				// double link field: list of clusters with wakeups
 
+    // Stacks of deleted tasks and coroutines are kept for reuse by the next task or coroutine created with the same
+    // stack size, so creation does not allocate. Each size holds at most stackCacheMax stacks.
+
+    enum { StackCacheSizes = 4 };			// number of distinct stack sizes cached
+    struct StackCache {
+	unsigned int size;				// stack size, 0 => entry unused
+	unsigned int count;				// number of cached stacks
+	void *stacks;					// list of stacks linked through the stack area
+    };
+    uSpinLock stackCacheLock;				// protect stackCache
+    StackCache stackCache[StackCacheSizes];
+    unsigned int stackCacheMax;				// high-water mark per stack size, 0 => no caching
+
     // Make a pointer to allow static declaration for uniprocessor.
 #if ! defined( __U_MULTI__ )
     static						// shared info on uniprocessor
 #endif // ! __U_MULTI__
     UPP::uNBIO *NBIO;					// non-blocking I/O facilities
+#if defined( __U_IO_URING__ )
+    UPP::uIOuring *volatile uring;			// asynchronous disk I/O, 0 => not created or io_uring unavailable
+    bool uringUnavailable;				// io_uring creation failed, so disk I/O uses blocking system calls
+#endif // __U_IO_URING__
+#ifdef __U_TICKLESS__
+    volatile unsigned int slicesArmed;			// processors timing a slice for this cluster, read without locking
+#endif // __U_TICKLESS__
 
     // profiling : necessary for compatibility between non-profiling and profiling
 
     mutable uProfileClusterSampler *profileClusterSamplerInstance; // pointer to related profiling object
 
     static void wakeProcessor( uPid_t pid );
-    void processorPause();
+    static void wakeProcessor( uProcessor &processor );
+    bool processorPause();
     void makeProcessorIdle( uProcessor &processor );
     void makeProcessorActive( uProcessor &processor );
     void makeProcessorActive();
+#ifdef __U_TICKLESS__
+    void timeSliceCompetition();
+    void armSlice();
+#endif // __U_TICKLESS__
 
     bool readyQueueEmpty() {
 	return readyQueue->empty();
@@ -2804,10 +3057,16 @@ class uCluster {
     void processorPoke();
 #endif // __U_MULTI__
     void createCluster( unsigned int stackSize, const char *name );
+    static void *&stackLink( void *storage, unsigned int size );
+    void *stackCacheGet( unsigned int size );
+    bool stackCachePut( void *storage, unsigned int size );
 
     int select( uIOClosure &closure, int rwe, timeval *timeout = NULL ) {
 	return NBIO->select( closure, rwe, timeout );
     } // uCluster::select
+#if defined( __U_IO_URING__ )
+    UPP::uIOuring *ioUring();				// create io_uring on first use
+#endif // __U_IO_URING__
   public:
     uCluster( unsigned int stackSize = uDefaultStackSize(), const char *name = "*unnamed*" );
     uCluster( const char *name );
@@ -2839,6 +3098,12 @@ class uCluster {
 	return stackSize;
     } // uCluster::getStackSize
 
+    unsigned int setStackCache( unsigned int max );	// set high-water mark and trim to it
+    unsigned int getStackCache() const {
+	return stackCacheMax;
+    } // uCluster::getStackCache
+    void trimStackCache( unsigned int keep = 0 );	// free cached stacks above keep per size
+
     void taskResetPriority( uBaseTask &owner, uBaseTask &calling );
     void taskSetPriority( uBaseTask &owner, uBaseTask &calling );
 
@@ -3056,11 +3321,15 @@ namespace UPP {
 	friend class UPP::uKernelBoot;			// access: startup, finishup
 	friend class UPP::uMachContext;			// access: startTask, finishup
 	friend class ::uBaseTask;			// access: prepareTask
+	friend class ::uProcessor;			// access: prepareProcessor, finishProcessor, affinityChanged
 	friend class UPP::PthreadLock;			// access: startup
 
 	static bool traceHeap_;				// trace allocations and deallocations
 
 	static void finishup();
+	static void prepareProcessor( uProcessor *processor );
+	static void finishProcessor( uProcessor *processor );
+	static void affinityChanged();
 	static void prepareTask( uBaseTask *task );
 	static void startTask();
 	static void finishTask();
@@ -3070,6 +3339,7 @@ namespace UPP {
 	static void startup();
       public:
 	static bool initialized();
+	static unsigned int trimInterval();		// background trim period (milliseconds), 0 => none
 
 	static bool traceHeap() {
 	    return traceHeap_;
@@ -3122,6 +3392,32 @@ namespace UPP {
     }; // uKernelBoot
 
 
+    // Within the scope of a uBlockingIO, the current task may execute on the blocking I/O cluster, so a system call that
+    // cannot be polled (open, stat, disk read) blocks a processor of that cluster rather than a processor of the task's
+    // cluster. Migration costs two context switches, so only the calls of a site whose recent calls were slow (e.g.,
+    // not satisfied from the page cache) migrate. The task migrates back at the end of the scope. Without a blocking
+    // I/O cluster (uniprocessor, or uDefaultBlockingIOProcessors returns 0), the call blocks in place.
+
+    class uBlockingIO {
+      public:
+	struct Site {					// call site of a system call that may be offloaded
+	    unsigned int average;			// recent duration of the calls (microseconds), exponentially weighted
+	}; // Site
+      private:
+	enum { SlowCall = 100 };			// average duration (microseconds) at and above which calls migrate
+
+	Site &site;
+	uCluster *home;					// cluster to return to, 0 => not migrated
+	unsigned long long int start;			// start of the call (nanoseconds), 0 => not measured
+
+	uBlockingIO( uBlockingIO & );			// no copy
+	uBlockingIO &operator=( uBlockingIO & );	// no assignment
+      public:
+	uBlockingIO( Site &site, bool offload = true );
+	~uBlockingIO();
+    }; // uBlockingIO
+
+
     class uInitProcessorsBoot {
 	static int count;
 
@@ -3152,6 +3448,7 @@ namespace UPP {
 
 
 #include <uBaseSelector.h>				// select statement
+#include <uIOuring.h>					// asynchronous disk I/O
 
 
 // debugging
@@ -35,6 +35,13 @@
 #endif // __U_PROFILER__
 //#include <uDebug.h>
 
+#include <cerrno>
+#include <cstring>					// strerror
+#ifdef __U_EVENTFD_PARK__
+#include <poll.h>					// ppoll
+#include <sys/eventfd.h>				// eventfd_read, eventfd_write
+#endif // __U_EVENTFD_PARK__
+
 
 using namespace UPP;
 
@@ -75,7 +82,35 @@ void uCluster::wakeProcessor( uPid_t pid ) {
 } // uCluster::wakeProcessor
 
 
-void uCluster::processorPause() {
+void uCluster::wakeProcessor( uProcessor &processor ) {
+#ifdef __U_EVENTFD_PARK__
+    // A processor parked in processorPause is woken by writing its eventfd, which is a single system call without
+    // signal delivery. The eventfd counter persists, so a write occurring before the processor blocks is not
+    // lost. Otherwise, the processor is blocked elsewhere (e.g., in select for the I/O poller) and must be
+    // interrupted by a signal.
+
+    if ( processor.parked ) {
+#ifdef __U_DEBUG_H__
+	uDebugPrt( "uCluster::wakeProcessor: unparking processor %p\n", &processor );
+#endif // __U_DEBUG_H__
+#ifdef __U_STATISTICS__
+	uFetchAdd( UPP::Statistics::wake_processor, 1 );
+#endif // __U_STATISTICS__
+	if ( ::eventfd_write( processor.parkFD, 1 ) == -1 && errno != EAGAIN ) { // EAGAIN => counter full so already woken
+	    uAbort( "uCluster::wakeProcessor : internal error, eventfd write failed, error(%d) %s.", errno, strerror( errno ) );
+	} // if
+	return;
+    } // if
+#endif // __U_EVENTFD_PARK__
+    wakeProcessor( processor.pid );
+} // uCluster::wakeProcessor
+
+
+bool uCluster::processorPause() {
+    // Returns true if the kernel thread blocked, false if work or a roll forward was found first.
+
+    bool slept = false;
+
     assert( THREAD_GETMEM( disableInt ) && THREAD_GETMEM( disableIntCnt ) > 0 );
 
     if ( uThisProcessor().getPreemption() != 0 ) {	// optimize out UNIX call if possible
@@ -113,6 +148,9 @@ void uCluster::processorPause() {
 #endif // __U_DEBUG_H__
 	} else {
 	    makeProcessorIdle( uThisProcessor() );
+#ifdef __U_EVENTFD_PARK__
+	    uThisProcessor().parked = true;		// set before release so waker sees it
+#endif // __U_EVENTFD_PARK__
 	    readyIdleTaskLock.release();
 
 #ifdef __U_DEBUG_H__
@@ -123,7 +161,35 @@ void uCluster::processorPause() {
 	    uFetchAdd( UPP::Statistics::kernel_thread_pause, 1 );
 #endif // __U_STATISTICS__
 
+#ifdef __U_EVENTFD_PARK__
+	    // Wait for a write to the eventfd with the old signal mask installed, so SIGALRM/SIGUSR1 for time slicing and
+	    // roll forward still interrupt the wait as with sigsuspend.
+	    pollfd park[3] = { { uThisProcessor().parkFD, POLLIN, 0 }, { -1, POLLIN, 0 }, { -1, POLLIN, 0 } };
+#if defined( __U_IO_URING__ )
+	    if ( uring != NULL ) park[1].fd = uring->eventFd; // io_uring completions also wake a parked processor
+#endif // __U_IO_URING__
+#if defined( __U_PROCESSOR_POLLERS__ )
+	    // With tasks waiting for I/O, one parked processor watches the cluster's epoll sets, so an I/O event wakes it
+	    // to poll the shards. The other processors stay parked.
+	    bool watching = NBIO->pending != 0 && uCompareAssign( NBIO->watcher, (uProcessor *)NULL, &uThisProcessor() );
+	    if ( watching ) park[2].fd = NBIO->epollFd;
+#endif // __U_PROCESSOR_POLLERS__
+	    if ( ::ppoll( park, 3, NULL, &old_mask ) > 0 ) {
+		if ( park[0].revents & POLLIN ) {
+		    eventfd_t count;
+		    ::eventfd_read( uThisProcessor().parkFD, &count ); // reset counter
+		} // if
+#if defined( __U_IO_URING__ )
+		if ( park[1].revents & POLLIN ) uring->reap(); // resets the completion eventfd
+#endif // __U_IO_URING__
+	    } // if
+#if defined( __U_PROCESSOR_POLLERS__ )
+	    if ( watching ) NBIO->watcher = NULL;	// events are polled by the scheduler loop
+#endif // __U_PROCESSOR_POLLERS__
+	    uThisProcessor().parked = false;
+#else
 	    sigsuspend( &old_mask );			// install old signal mask over new one and wait for signal to arrive
+#endif // __U_EVENTFD_PARK__
 
 	    if ( sigprocmask( SIG_SETMASK, &old_mask, NULL ) == -1 ) { // new mask restored so install old signal mask over new one
 		uAbort( "internal error, sigprocmask" );
@@ -138,6 +204,7 @@ void uCluster::processorPause() {
 #endif // __U_DEBUG_H__
 
 	    makeProcessorActive( uThisProcessor() );
+	    slept = true;
 	} // if
     } // if
 
@@ -153,6 +220,7 @@ void uCluster::processorPause() {
     // the backside of the next scheduled task.
 
     assert( THREAD_GETMEM( disableInt ) && THREAD_GETMEM( disableIntCnt ) > 0 );
+    return slept;
 } // uCluster::processorPause
 
 
@@ -184,10 +252,10 @@ void uCluster::makeProcessorActive() {
 #endif // __U_DEBUG_H__
     readyIdleTaskLock.acquire();
     if ( ! readyQueue->empty() && ! idleProcessors.empty() ) {
-	uPid_t pid = idleProcessors.dropHead()->processor().pid;
+	uProcessor &processor = idleProcessors.dropHead()->processor();
 	idleProcessorsCnt -= 1;
-	readyIdleTaskLock.release();			// don't hold lock while sending SIGALRM
-	wakeProcessor( pid );
+	readyIdleTaskLock.release();			// don't hold lock while waking processor
+	wakeProcessor( processor );
     } else {
 	readyIdleTaskLock.release();
     } // if
@@ -195,6 +263,27 @@ void uCluster::makeProcessorActive() {
 
 
 void uCluster::makeTaskReady( uBaseTask &readyTask ) {
+    if ( selfLockingReadyQueue && &readyTask.bound == NULL && &uThisCluster() == this ) {
+#ifdef __U_DEBUG_H__
+	uDebugPrt( "(uCluster &)%p.makeTaskReady(3): task %.256s (%p) makes task %.256s (%p) ready\n",
+		   this, uThisTask().getName(), &uThisTask(), readyTask.getName(), &readyTask );
+#endif // __U_DEBUG_H__
+	// The scheduler adds the task to the executing processor's queue without the ready/idle lock. This processor
+	// is awake and eventually runs the task itself, so a wakeup cannot be lost; idle processors are only woken to
+	// steal the new work, and the unlocked idle count is a sufficient hint for that.
+	readyQueue->add( &(readyTask.readyRef) );
+#ifdef __U_MULTI__
+	if ( idleProcessorsCnt != 0 ) {
+	    makeProcessorActive();
+#ifdef __U_TICKLESS__
+	} else {
+	    timeSliceCompetition();			// no idle processor so task competes with executing tasks
+#endif // __U_TICKLESS__
+	} // if
+#endif // __U_MULTI__
+	return;
+    } // if
+
     readyIdleTaskLock.acquire();
     if ( &readyTask.bound != NULL ) {			// task bound to a specific processor ?
 #ifdef __U_DEBUG_H__
@@ -207,9 +296,8 @@ void uCluster::makeTaskReady( uBaseTask &readyTask ) {
 	if ( p->idle() ) {				// processor on idle queue ?
 	    idleProcessors.remove( &(p->idleRef) );
 	    idleProcessorsCnt -= 1;
-	    uPid_t pid = p->pid;
-	    readyIdleTaskLock.release();		// don't hold lock while sending SIGALRM
-	    wakeProcessor( pid );
+	    readyIdleTaskLock.release();		// don't hold lock while waking processor
+	    wakeProcessor( *p );
 	} else {
 	    readyIdleTaskLock.release();
 	} // if
@@ -234,12 +322,18 @@ void uCluster::makeTaskReady( uBaseTask &readyTask ) {
 //	if ( ! idleProcessors.empty() && ( &uThisCluster() != this || duration > 300000 ) ) {
 //	    uThisProcessor().startTime = uRead_tsc();
 #endif
-	    uPid_t pid = idleProcessors.dropHead()->processor().pid;
+	    uProcessor &processor = idleProcessors.dropHead()->processor();
 	    idleProcessorsCnt -= 1;
-	    readyIdleTaskLock.release();		// don't hold lock while sending SIGALRM
-	    wakeProcessor( pid );
+	    readyIdleTaskLock.release();		// don't hold lock while waking processor
+	    wakeProcessor( processor );
 	} else {
+#ifdef __U_TICKLESS__
+	    bool competition = idleProcessors.empty();
+	    readyIdleTaskLock.release();
+	    if ( competition ) timeSliceCompetition();	// no idle processor so task competes with executing tasks
+#else
 	    readyIdleTaskLock.release();
+#endif // __U_TICKLESS__
 	} // if
 #else
 	readyIdleTaskLock.release();
@@ -270,10 +364,9 @@ void uCluster::makeTaskReady( uBaseTaskSeq &newTasks, unsigned int n ) {
 	    restart.addTail( idleProcessors.dropHead() );
 	    idleProcessorsCnt -= 1;
 	} // for
-	readyIdleTaskLock.release();			// don't hold lock while sending SIGALRM
+	readyIdleTaskLock.release();			// don't hold lock while waking processors
 	for ( ; ! restart.empty(); ) {
-	    uPid_t pid = restart.dropHead()->processor().pid;
-	    wakeProcessor( pid );
+	    wakeProcessor( restart.dropHead()->processor() );
 	} // for
     } else {
 	readyIdleTaskLock.release();
@@ -296,6 +389,12 @@ uBaseTask &uCluster::readyQueueTryRemove() {
 
     uBaseTask *task;
 
+    if ( selfLockingReadyQueue ) {			// scheduler handles its own concurrency (and stealing)
+	uBaseTaskDL *node = readyQueue->drop();
+	task = node != NULL ? &(node->task()) : NULL;
+	return *task;
+    } // if
+
     readyIdleTaskLock.acquire();
     if ( ! readyQueueEmpty() ) {
 	task = &(readyQueue->drop()->task());
@@ -334,6 +433,7 @@ void uCluster::processorAdd( uProcessor &processor ) {
     processorsOnClusterLock.acquire();
     numProcessors += 1;
     processorsOnCluster.addTail( &(processor.processorRef) );
+    readyQueue->processorAdd( processor );		// scheduler may give processor its own ready queue
     processorsOnClusterLock.release();
 } // uCluster::processorAdd
 
@@ -342,10 +442,58 @@ void uCluster::processorRemove( uProcessor &processor ) {
     processorsOnClusterLock.acquire();
     numProcessors -= 1;
     processorsOnCluster.remove( &(processor.processorRef) );
+    readyQueue->processorRemove( processor );		// scheduler moves tasks on processor's queue to remaining processors
     processorsOnClusterLock.release();
 } // uCluster::processorRemove
 
 
+#ifdef __U_TICKLESS__
+void uCluster::timeSliceCompetition() {
+    // A task is ready and no processor on this cluster is idle, so ensure some processor on the cluster has its time
+    // slice armed. Usually one is, which the count of armed slices shows without locking; the fence orders the ready
+    // task before the read, and a lapsing slice checks for competition again after it is uncounted. If the executing
+    // processor is on the cluster, it arms its own slice. The kernel checks the slice before running a task, so
+    // nothing is needed when called from the kernel or from roll forward, which yields or returns to the kernel.
+
+    __sync_synchronize();
+  if ( slicesArmed != 0 ) return;			// some processor timing a slice ?
+
+    THREAD_GETMEM( This )->disableInterrupts();
+    uProcessor &processor = uThisProcessor();
+    if ( processor.currCluster == this && processor.preemption != 0 ) {
+	if ( ! THREAD_GETMEM( RFinprogress ) ) {
+	    processor.armContextSwitchEvent();
+	} // if
+	THREAD_GETMEM( This )->enableInterrupts();
+	return;
+    } // if
+    THREAD_GETMEM( This )->enableInterrupts();
+
+    armSlice();
+} // uCluster::timeSliceCompetition
+
+
+void uCluster::armSlice() {
+    // Task made ready from another cluster, or a slice removed while tasks wait, so arm the slice of a preemptive
+    // processor on this cluster unless one is already timing its slice. The processor is not interrupted; its task is
+    // preempted when the slice expires.
+
+    processorsOnClusterLock.acquire();
+    if ( slicesArmed == 0 ) {				// recheck under lock
+	uProcessorDL *pr;
+	for ( uSeqIter<uProcessorDL> iter( processorsOnCluster ); iter >> pr; ) {
+	    uProcessor &p = pr->processor();
+	    if ( p.preemption != 0 ) {
+		p.armContextSwitchEvent();
+		break;
+	    } // if
+	} // for
+    } // if
+    processorsOnClusterLock.release();
+} // uCluster::armSlice
+#endif // __U_TICKLESS__
+
+
 #if defined( __U_MULTI__ )
 void uCluster::processorPoke() {
     processorsOnClusterLock.acquire();
@@ -392,9 +540,17 @@ void uCluster::createCluster( unsigned int stackSize, const char *name ) {
 
     numProcessors = 0;
     idleProcessorsCnt = 0;
+#ifdef __U_TICKLESS__
+    slicesArmed = 0;
+#endif // __U_TICKLESS__
 
     setName( name );
     setStackSize( stackSize );
+    for ( unsigned int i = 0; i < StackCacheSizes; i += 1 ) {
+	stackCache[i].size = stackCache[i].count = 0;
+	stackCache[i].stacks = NULL;
+    } // for
+    stackCacheMax = uDefaultStackCache();
 
 #if __U_LOCALDEBUGGER_H__
     if ( uLocalDebugger::uLocalDebuggerActive ) uLocalDebugger::uLocalDebuggerInstance->checkPoint();
@@ -414,11 +570,18 @@ void uCluster::createCluster( unsigned int stackSize, const char *name ) {
     } else {
 	defaultReadyQueue = false;
     } // if
+    selfLockingReadyQueue = readyQueue->internalLocking();
+    fifoReadyQueue = defaultReadyQueue || readyQueue == uKernelModule::systemScheduler;
 
 #ifdef __U_MULTI__
     NBIO = new uNBIO;
 #endif // __U_MULTI__
 
+#if defined( __U_IO_URING__ )
+    uring = NULL;					// created by the first I/O on a descriptor that cannot be polled
+    uringUnavailable = false;
+#endif // __U_IO_URING__
+
 #ifdef __U_PROFILER__
     if ( uProfiler::uProfiler_registerCluster ) {
 	(*uProfiler::uProfiler_registerCluster)( uProfiler::profilerInstance, *this );
@@ -458,6 +621,9 @@ uCluster::~uCluster() {
     } // if
 #endif // __U_PROFILER__
 
+#if defined( __U_IO_URING__ )
+    delete uring;
+#endif // __U_IO_URING__
 #ifdef __U_MULTI__
     delete NBIO;
 #endif // __U_MULTI__
@@ -487,6 +653,10 @@ uCluster::~uCluster() {
     } // if
 #endif // __U_DEBUG__
 
+    // Stacks of tasks deleted after this point (e.g., during shutdown of the system cluster) are freed directly.
+    stackCacheMax = 0;
+    trimStackCache( 0 );
+
     if ( defaultReadyQueue ) {				// delete if cluster allocated it
 	delete readyQueue;
     } // if
@@ -501,6 +671,97 @@ uCluster::~uCluster() {
 } // uCluster::~uCluster
 
 
+// A cached stack is linked through its first word above the guard page, which stays write protected while cached, so
+// reuse does not need an mprotect.
+
+void *&uCluster::stackLink( void *storage, unsigned int size ) {
+    return *(void **)((char *)storage + UPP::uMachContext::stackGuard( size ));
+} // uCluster::stackLink
+
+
+void *uCluster::stackCacheGet( unsigned int size ) {
+  if ( stackCacheMax == 0 ) return NULL;		// caching off ?
+    void *storage = NULL;
+    stackCacheLock.acquire();
+    for ( unsigned int i = 0; i < StackCacheSizes; i += 1 ) {
+	if ( stackCache[i].size == size ) {
+	    storage = stackCache[i].stacks;
+	    if ( storage != NULL ) {
+		stackCache[i].stacks = stackLink( storage, size );
+		stackCache[i].count -= 1;
+	    } // if
+	    break;
+	} // if
+    } // for
+    stackCacheLock.release();
+#ifdef __U_STATISTICS__
+    uFetchAdd( storage != NULL ? UPP::Statistics::stack_cache_hits : UPP::Statistics::stack_cache_misses, 1 );
+#endif // __U_STATISTICS__
+    return storage;
+} // uCluster::stackCacheGet
+
+
+bool uCluster::stackCachePut( void *storage, unsigned int size ) {
+  if ( stackCacheMax == 0 ) return false;		// caching off ?
+    if ( UPP::uMachContext::stackMmap( size ) ) {	// outside lock as system call
+	UPP::uMachContext::releaseStorage( storage, size ); // cached stack holds no memory
+    } // if
+    bool cached = false;
+    stackCacheLock.acquire();
+    StackCache *free = NULL;
+    unsigned int i;
+    for ( i = 0; i < StackCacheSizes; i += 1 ) {
+      if ( stackCache[i].size == size ) break;
+	if ( free == NULL && stackCache[i].count == 0 ) free = &stackCache[i]; // unused or empty entry
+    } // for
+    StackCache *entry = i < StackCacheSizes ? &stackCache[i] : free;
+    if ( entry != NULL && entry->count < stackCacheMax ) { // below high-water mark ?
+	entry->size = size;				// (re)assign entry
+	stackLink( storage, size ) = entry->stacks;
+	entry->stacks = storage;
+	entry->count += 1;
+	cached = true;
+    } // if
+    stackCacheLock.release();
+    return cached;
+} // uCluster::stackCachePut
+
+
+unsigned int uCluster::setStackCache( unsigned int max ) {
+    unsigned int prev = stackCacheMax;
+    stackCacheMax = max;
+    trimStackCache( max );
+    return prev;
+} // uCluster::setStackCache
+
+
+void uCluster::trimStackCache( unsigned int keep ) {
+    for ( unsigned int i = 0; i < StackCacheSizes; i += 1 ) {
+	// Remove excess stacks under the lock but free them after releasing it.
+	void *excess = NULL;
+	stackCacheLock.acquire();
+	unsigned int size = stackCache[i].size;
+	while ( stackCache[i].count > keep ) {
+	    void *storage = stackCache[i].stacks;
+	    stackCache[i].stacks = stackLink( storage, size );
+	    stackCache[i].count -= 1;
+	    stackLink( storage, size ) = excess;
+	    excess = storage;
+	} // while
+	stackCacheLock.release();
+
+	while ( excess != NULL ) {
+	    void *storage = excess;
+	    excess = stackLink( storage, size );
+	    UPP::uMachContext::freeStorage( storage, size );
+#ifdef __U_STATISTICS__
+	    uFetchAdd( UPP::Statistics::stack_cache_trims, 1 );
+#endif // __U_STATISTICS__
+	} // while
+    } // for
+} // uCluster::trimStackCache
+
+
 void uCluster::taskResetPriority( uBaseTask &owner, uBaseTask &calling ) { // TEMPORARY
 #ifdef __U_DEBUG_H__
     uDebugPrt( "(uCluster &)%p.taskResetPriority, owner:%p, calling:%p, owner's cluster:%p\n", this, &owner, &calling, owner.currCluster );
@@ -541,6 +802,28 @@ int uCluster::select( int fd, int rwe, timeval *timeout ) {
 } // uCluster::select
 
 
+#if defined( __U_IO_URING__ )
+UPP::uIOuring *uCluster::ioUring() {
+    // Most clusters never perform disk I/O, so the ring, its mappings and its eventfd are created by the first operation
+    // that needs them. Racing tasks may each create a ring, and all but the first one installed are deleted.
+
+  if ( uring != NULL || uringUnavailable ) return uring;
+    uIOuring *ring = new uIOuring;
+    if ( ! ring->usable() ) {				// no io_uring in this OS => blocking system calls
+	delete ring;
+	uringUnavailable = true;
+	return NULL;
+    } // if
+    if ( ! uCompareAssign( uring, (uIOuring *)NULL, ring ) ) { // another task installed a ring ?
+	delete ring;
+	return uring;
+    } // if
+    NBIO->registerFD( ring->eventFd );			// completions also wake a processor blocked in the I/O poller
+    return ring;
+} // uCluster::ioUring
+#endif // __U_IO_URING__
+
+
 // Local Variables: //
 // compile-command: "make install" //
 // End: //
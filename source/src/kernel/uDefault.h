@@ -41,6 +41,27 @@
 #define __U_DEFAULT_MMAP_START__ (96 * 1024)
 
 
+// Define the default huge-page mode for the heap: 0 => none, 1 => heap extension and mmapped blocks of at least 2 MB
+// are 2 MB aligned and sized and advised to use transparent huge pages, 2 => as 1 but first try MAP_HUGETLB for
+// mmapped blocks. The default routine reads the mode from environment variable UCPP_HEAP_HUGEPAGES, if set.
+
+#define __U_DEFAULT_HEAP_HUGEPAGES__ 0
+
+
+// Define the default heap-profile sampling rate in bytes: on average, one allocation is sampled every this many bytes
+// allocated, 0 => no sampling. The default routine reads the rate from environment variable UCPP_HEAP_SAMPLE, if set.
+
+#define __U_DEFAULT_HEAP_SAMPLE__ 0
+
+
+// Define the default file of heap bucket sizes, 0 => built-in sizes. The file lists allocation sizes in bytes separated
+// by white space or commas, and '#' starts a comment to the end of the line. Each size gets a bucket that holds a
+// request of that size, and built-in sizes fill the rest of the buckets. The default routine reads the file name from
+// environment variable UCPP_HEAP_BUCKETS, if set.
+
+#define __U_DEFAULT_HEAP_BUCKETS__ 0
+
+
 // Define the default scheduling pre-emption time in milliseconds.  A scheduling pre-emption is attempted every default
 // pre-emption milliseconds.  A pre-emption does not occur if the executing task is not in user code or the task is
 // currently in a critical section.  A critical section begins when a task acquires a lock and ends when a user releases
@@ -50,11 +71,19 @@
 
 
 // Define the default spin time in units of checks and context switches. The idle task checks the ready queue and
-// context switches this many times before the UNIX process executing the idle task goes to sleep.
+// context switches at most this many times before the UNIX process executing the idle task goes to sleep.
 
 #define __U_DEFAULT_SPIN__ 1000
 
 
+// Define the bounds in nanoseconds of the adaptive idle-spin budget on a multiprocessor. The initial budget is the time
+// taken by the spin count above, and afterwards an idle processor spins for its current budget before sleeping. The budget grows when work arrives just
+// after spinning stops or late in a spin, and shrinks when the processor sleeps for long periods.
+
+#define __U_DEFAULT_SPIN_MIN_NS__ 1000
+#define __U_DEFAULT_SPIN_MAX_NS__ 200000
+
+
 // Define the default stack size in bytes.  Change the implicit default stack size for a task or coroutine created on a
 // particular cluster.
 
@@ -69,14 +98,39 @@
 #define __U_DEFAULT_MAIN_STACK_SIZE__ 500000
 
 
+// Define the default number of stacks of each size a cluster keeps for reuse after tasks and coroutines are deleted.
+// Zero disables stack caching.
+
+#define __U_DEFAULT_STACK_CACHE__ 128
+
+
+// Define the default stack size in bytes at or above which a stack is reserved with mmap rather than allocated from the
+// heap. Such stacks have a guard page in all builds, and pages are only committed when touched and are released when
+// the stack is cached for reuse, so large stacks only cost the memory actually used. Zero disables mmap stacks.
+
+#define __U_DEFAULT_STACK_MMAP__ 0
+
+
 // Define the default number of processors created on the user cluster. May not be less than 1.
 
 #define __U_DEFAULT_PROCESSORS__ 1
 
 
+// Define the default number of processors created on the blocking I/O cluster (multiprocessor only). Tasks migrate to
+// this cluster for slow system calls that cannot be polled, such as open, stat and disk reads, so these calls block one
+// of its processors rather than a processor running other tasks. Zero disables offloading.
+
+#define __U_DEFAULT_BLOCKING_IO_PROCESSORS__ 0
+
+
 extern unsigned int uDefaultHeapExpansion();		// heap expansion size (bytes)
 extern unsigned int uDefaultMmapStart();		// cross over point to use mmap rather than buckets
+extern unsigned int uDefaultHeapHugePages();		// heap huge-page mode
+extern unsigned int uDefaultHeapSample();		// heap-profile sampling rate (bytes)
+extern const char *uDefaultHeapBuckets();		// file of heap bucket sizes
 extern unsigned int uDefaultStackSize();		// cluster coroutine/task stack size (bytes)
+extern unsigned int uDefaultStackCache();		// cluster stacks cached per stack size
+extern unsigned int uDefaultStackMmap();		// stack size at or above which stacks are mmapped (bytes)
 extern unsigned int uMainStackSize();			// uMain task stack size (bytes)
 extern unsigned int uDefaultSpin();			// processor spin time for idle task (context switches)
 extern unsigned int uDefaultPreemption();		// processor scheduling pre-emption durations (milliseconds)
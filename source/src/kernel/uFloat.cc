@@ -29,10 +29,13 @@
 #include <uC++.h>
 
 
-#ifdef __U_FLOATINGPOINTDATASIZE__
+#if defined( __U_FLOATINGPOINTDATASIZE__ ) || defined( __U_FLOATINGPOINTCONTROL__ )
 uFloatingPointContext::uFloatingPointContext() : uContext( &uniqueKey ) {
+#ifdef __U_FLOATINGPOINTCONTROL__
+    save();						// initial control state is the creator's
+#endif // __U_FLOATINGPOINTCONTROL__
 } // uFloatingPointContext::uFloatingPointContext
-#endif // __U_FLOATINGPOINTDATASIZE__
+#endif // __U_FLOATINGPOINTDATASIZE__ || __U_FLOATINGPOINTCONTROL__
 
 #if defined( __ia64__ )
 extern "C" void uIA64FPsave( double cxt[] );
@@ -41,10 +44,12 @@ extern "C" void uIA64FPrestore( double cxt[] );
 
 void uFloatingPointContext::save() {
     
-#if defined( __i386__ )
-    // saved by caller
-#elif defined( __x86_64__ )
-    // saved by caller
+#if defined( __i386__ ) || defined( __x86_64__ )
+    // registers saved by caller, control registers are callee saved
+    asm volatile ( "fnstcw %0" : "=m" (fpucw) );
+#if defined( __SSE__ )
+    asm volatile ( "stmxcsr %0" : "=m" (mxcsr) );
+#endif // __SSE__
 #elif defined( __ia64__ )
 #   if ! defined( __U_SWAPCONTEXT__ )
 	uIA64FPsave( floatingPointData );
@@ -60,10 +65,20 @@ void uFloatingPointContext::save() {
 
 void uFloatingPointContext::restore() {
     
-#if defined( __i386__ )
-    // restored by caller
-#elif defined( __x86_64__ )
-    // restored by caller
+#if defined( __i386__ ) || defined( __x86_64__ )
+    // registers restored by caller, control registers are reloaded only if changed because loading is expensive
+    unsigned short int cw;
+    asm volatile ( "fnstcw %0" : "=m" (cw) );
+    if ( cw != fpucw ) {
+	asm volatile ( "fldcw %0" : : "m" (fpucw) );
+    } // if
+#if defined( __SSE__ )
+    unsigned int csr;
+    asm volatile ( "stmxcsr %0" : "=m" (csr) );
+    if ( csr != mxcsr ) {
+	asm volatile ( "ldmxcsr %0" : : "m" (mxcsr) );
+    } // if
+#endif // __SSE__
 #elif defined( __ia64__ )
 #if ! defined( __U_SWAPCONTEXT__ )
     uIA64FPrestore( floatingPointData );
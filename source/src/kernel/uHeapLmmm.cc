@@ -29,6 +29,8 @@
 #include <uC++.h>
 #include <uHeapLmmm.h>
 #include <uAlign.h>
+#include <uRegion.h>
+#include <uSystemTask.h>
 #ifdef __U_PROFILER__
 #include <uProfiler.h>
 #endif // __U_PROFILER__
@@ -40,7 +42,18 @@
 #include <cstdio>
 #include <cstring>
 #include <new>
-#include <unistd.h>					// sbrk, sysconf
+#include <cstdlib>					// strtoull, strtoul
+#include <unistd.h>					// sbrk, sysconf, read, close
+#include <sched.h>					// sched_getaffinity
+#include <fcntl.h>					// open
+#if defined( __linux__ )
+#include <sys/syscall.h>				// SYS_mbind
+#include <execinfo.h>					// backtrace
+#endif // __linux__
+
+#ifndef MPOL_PREFERRED
+#define MPOL_PREFERRED 1				// mbind policy, from numaif.h
+#endif // MPOL_PREFERRED
 
 #define likely(x)       __builtin_expect(!!(x), 1)
 #define unlikely(x)     __builtin_expect(!!(x), 0)
@@ -55,6 +68,7 @@ namespace UPP {
     uHeapManager *uHeapManager::heapManagerInstance = NULL;
     size_t uHeapManager::pageSize;
     unsigned int uHeapManager::maxBucketsUsed;
+    bool uHeapManager::customBuckets = false;
     size_t uHeapManager::heapExpand;
     size_t uHeapManager::mmapStart;
 
@@ -77,7 +91,34 @@ namespace UPP {
     unsigned char uHeapManager::lookup[];		// array size defined in .h
 #endif // FASTLOOKUP
 
+    // Alignments commonly requested for cache-line padded objects and pages. The blocks of an aligned size class are
+    // multiples of its alignment, so user storage carved at an aligned address stays aligned and needs no fake header.
+    unsigned int uHeapManager::alignments[uHeapManager::NoAlignments] = { 64, 128, 4096 };
+    unsigned char uHeapManager::alignedMultiples[uHeapManager::AlignedMultiples] = { 1, 2, 3, 4, 6, 8, 12, 16 };
+
     int uHeapManager::mmapFd = -1;
+    uHeapManager::ProcessorCache *uHeapManager::spareCaches = NULL;
+#ifdef __U_STATISTICS__
+    uHeapManager::ProcessorCache *uHeapManager::allCaches = NULL;
+#endif // __U_STATISTICS__
+    void *uHeapManager::spareChunks = NULL;
+    unsigned int uHeapManager::spareChunkCount = 0;
+    size_t uHeapManager::trimThreshold = 0;
+    unsigned int uHeapManager::trimInterval = 0;
+    volatile size_t uHeapManager::freedSinceTrim = 0;
+    unsigned int uHeapManager::hugePages = uHeapManager::HugeNone;
+    unsigned int uHeapManager::numaNodes = 0;
+    bool uHeapManager::numaArenas = false;
+    volatile unsigned int uHeapManager::arenaGeneration = 1; // new caches (generation 0) bind on first use
+    char *uHeapManager::numaBase = NULL;
+    size_t uHeapManager::numaReserve = 0;
+    unsigned char uHeapManager::cpuNodes[uHeapManager::MaxNumaCpus];
+    size_t uHeapManager::numaSpan = 0;
+    uHeapManager *uHeapManager::arenas[uHeapManager::MaxNumaNodes];
+    size_t uHeapManager::sampleRate = 0;
+    uHeapManager::Profile *uHeapManager::profile = NULL;
+    volatile bool uHeapManager::profileRequested = false;
+    int uHeapManager::profileFd = 2;			// default stderr
 #ifdef __U_DEBUG__
     unsigned long int uHeapManager::allocfree = 0;
 #endif // __U_DEBUG__
@@ -98,13 +139,67 @@ namespace UPP {
     unsigned int uHeapManager::calloc_calls = 0;
     unsigned long long int uHeapManager::memalign_storage = 0;
     unsigned int uHeapManager::memalign_calls = 0;
+    unsigned int uHeapManager::memalign_native = 0;
     unsigned long long int uHeapManager::cmemalign_storage = 0;
     unsigned int uHeapManager::cmemalign_calls = 0;
     unsigned long long int uHeapManager::realloc_storage = 0;
     unsigned int uHeapManager::realloc_calls = 0;
+    unsigned int uHeapManager::realloc_inplace = 0;
+    unsigned int uHeapManager::realloc_mremap = 0;
+    unsigned int uHeapManager::cache_alloc_hits = 0;
+    unsigned int uHeapManager::cache_alloc_refills = 0;
+    unsigned int uHeapManager::cache_free_hits = 0;
+    unsigned int uHeapManager::cache_free_flushes = 0;
+    unsigned int uHeapManager::trim_calls = 0;
+    unsigned long long int uHeapManager::trim_madvise_storage = 0;
+    unsigned long long int uHeapManager::trim_sbrk_storage = 0;
+    unsigned long long int uHeapManager::huge_advise_storage = 0;
+    unsigned long long int uHeapManager::huge_tlb_storage = 0;
+    unsigned int uHeapManager::numa_calls = 0;
+    unsigned int uHeapManager::numa_fallbacks = 0;
+    unsigned int uHeapManager::region_chunks = 0;
+    unsigned int uHeapManager::region_reuses = 0;
+    unsigned int uHeapManager::region_frees = 0;
+    unsigned long long int uHeapManager::numa_storage = 0;
+    uHeapManager::BucketStats uHeapManager::bucketStats[uHeapManager::NoBucketSizes + uHeapManager::NoAlignedSizes];
+    unsigned long long int uHeapManager::inUse = 0;
+    unsigned long long int uHeapManager::peakInUse = 0;
 
     int uHeapManager::statfd = 2;			// default stderr
 
+    // Amount of process storage backed by transparent huge pages, or 0 if unknown. Uses "open/read" because it is called
+    // while printing statistics.
+    static unsigned long long int hugeBacked() {
+#if defined( __linux__ )
+	int fd = ::open( "/proc/self/smaps_rollup", O_RDONLY );
+      if ( fd == -1 ) return 0;
+	char buf[4096];
+	ssize_t len = ::read( fd, buf, sizeof(buf) - 1 );
+	::close( fd );
+      if ( len <= 0 ) return 0;
+	buf[len] = '\0';
+	const char *field = strstr( buf, "AnonHugePages:" );
+      if ( field == NULL ) return 0;
+	return strtoull( field + sizeof("AnonHugePages:") - 1, NULL, 10 ) * 1024; // kB
+#else
+	return 0;
+#endif // __linux__
+    } // hugeBacked
+
+    size_t uHeapManager::lowerSize( unsigned int bucket ) {
+	// Largest block size of the size class below the bucket, so the bucket serves block sizes above it. The aligned
+	// size classes of each alignment are separate.
+
+      if ( bucket == 0 || bucket == NoBucketSizes ) return 0;
+      if ( bucket > NoBucketSizes && ( bucket - NoBucketSizes ) % AlignedMultiples == 0 ) return 0;
+	return heapManagerInstance->freeLists[bucket - 1].blockSize;
+    } // uHeapManager::lowerSize
+
+    inline void uHeapManager::allocated( size_t tsize ) {
+	unsigned long long int used = uFetchAdd( inUse, tsize ) + tsize;
+	if ( unlikely( used > peakInUse ) ) peakInUse = used; // racy, but only a statistic
+    } // uHeapManager::allocated
+
     // Use "write" because streams may be shutdown when calls are made.
     void uHeapManager::print() {
 	char helpText[512];
@@ -129,6 +224,91 @@ namespace UPP {
 			   sbrk_calls, sbrk_storage
 	    );
 	uDebugWrite( statfd, helpText, len );
+
+	// Freed blocks held in the processor caches are not in use but are not on the free lists either. The counts are
+	// read without interrupts disabled on the owning processors, so they are approximate while tasks execute.
+	unsigned long long int cachedBlocks = 0, cachedStorage = 0;
+	heapManagerInstance->extlock.acquire();
+	for ( ProcessorCache *cache = allCaches; cache != NULL; cache = cache->nextCache ) {
+	    for ( unsigned int i = 0; i < NoBucketSizes + NoAlignedSizes; i += 1 ) {
+		cachedBlocks += cache->buckets[i].count;
+		cachedStorage += (unsigned long long int)cache->buckets[i].count * heapManagerInstance->freeLists[i].blockSize;
+	    } // for
+	} // for
+	heapManagerInstance->extlock.release();
+	unsigned int allocs = cache_alloc_hits + cache_alloc_refills, frees = cache_free_hits + cache_free_flushes;
+	len = snprintf( helpText, 512, "  processor cache: alloc hits %u / refills %u (hit rate %u%%)"
+			" / free hits %u / flushes %u (hit rate %u%%) / cached blocks %llu / storage %llu\n",
+			cache_alloc_hits, cache_alloc_refills, allocs != 0 ? (unsigned int)( 100ULL * cache_alloc_hits / allocs ) : 0,
+			cache_free_hits, cache_free_flushes, frees != 0 ? (unsigned int)( 100ULL * cache_free_hits / frees ) : 0,
+			cachedBlocks, cachedStorage
+	    );
+	uDebugWrite( statfd, helpText, len );
+
+	len = snprintf( helpText, 512, "  memalign: aligned size class %u\n"
+			"  realloc: in place %u / mremap %u\n"
+			"  region: chunks %u / reused %u / freed %u\n"
+			"  trim: calls %u / released %llu (madvise %llu / sbrk %llu)\n",
+			memalign_native,
+			realloc_inplace, realloc_mremap,
+			region_chunks, region_reuses, region_frees,
+			trim_calls, trim_madvise_storage + trim_sbrk_storage, trim_madvise_storage, trim_sbrk_storage
+	    );
+	uDebugWrite( statfd, helpText, len );
+
+	if ( hugePages != HugeNone || huge_advise_storage != 0 || huge_tlb_storage != 0 ) {
+	    len = snprintf( helpText, 512, "  huge pages: advised %llu / hugetlb %llu / transparent backed %llu\n",
+			    huge_advise_storage, huge_tlb_storage, hugeBacked()
+		);
+	    uDebugWrite( statfd, helpText, len );
+	} // if
+
+	if ( numaSpan != 0 ) {
+	    unsigned int created = 0;
+	    for ( unsigned int i = 0; i < numaNodes; i += 1 ) {
+		if ( arenas[i] != NULL ) created += 1;
+	    } // for
+	    len = snprintf( helpText, 512, "  numa: nodes %u / arenas %u / extend calls %u / storage %llu / main heap fallbacks %u\n",
+			    numaNodes, created, numa_calls, numa_storage, numa_fallbacks
+		);
+	    uDebugWrite( statfd, helpText, len );
+	} // if
+
+	if ( profile != NULL ) {
+	    len = snprintf( helpText, 512, "  heap profile: rate %zu / sites %u / samples %u / dropped %llu\n",
+			    sampleRate, profile->usedSites, profile->usedSamples, profile->dropped
+		);
+	    uDebugWrite( statfd, helpText, len );
+	} // if
+
+	// Fragmentation is the part of the bucket storage given to allocations that was not requested (headers and
+	// rounding up to the bucket size). The histogram divides the request sizes (plus header) served by a bucket into
+	// equal parts from the size below the bucket to the bucket size.
+	unsigned long long int requested = 0, blocks = 0;
+	for ( unsigned int i = 0; i < NoBucketSizes + NoAlignedSizes; i += 1 ) {
+	    requested += bucketStats[i].requested;
+	    blocks += (unsigned long long int)bucketStats[i].allocs * heapManagerInstance->freeLists[i].blockSize;
+	} // for
+	len = snprintf( helpText, 512, "  in use: storage %llu / peak %llu / bucket fragmentation %u%%%s\n"
+			"  buckets (size: allocs / live / peak live / fragmentation / request-size histogram)\n",
+			inUse, peakInUse, blocks != 0 ? (unsigned int)( 100 - 100 * requested / blocks ) : 0,
+			customBuckets ? " (custom sizes)" : ""
+	    );
+	uDebugWrite( statfd, helpText, len );
+	for ( unsigned int i = 0; i < NoBucketSizes + NoAlignedSizes; i += 1 ) {
+	    BucketStats &stats = bucketStats[i];
+	  if ( stats.allocs == 0 ) continue;
+	    unsigned long long int storage = (unsigned long long int)stats.allocs * heapManagerInstance->freeLists[i].blockSize;
+	    len = snprintf( helpText, 512, "  %7zu%s: %u / %u / %u / %u%% /",
+			    heapManagerInstance->freeLists[i].blockSize, i < NoBucketSizes ? "" : "a",
+			    stats.allocs, stats.live, stats.peak, (unsigned int)( 100 - 100 * stats.requested / storage )
+		);
+	    for ( unsigned int b = 0; b < HistogramBins; b += 1 ) {
+		len += snprintf( helpText + len, 512 - len, " %u", stats.histogram[b] );
+	    } // for
+	    helpText[len] = '\n';
+	    uDebugWrite( statfd, helpText, len + 1 );
+	} // for
     } // uHeapManager::print
 #endif // __U_STATISTICS__
 
@@ -161,6 +341,257 @@ namespace UPP {
 	return false;
     } // uHeapManager::setMmapStart
 
+    bool uHeapManager::setHugePages( unsigned int value ) {
+      if ( value > HugeTLB ) return true;
+	hugePages = value;
+	return false;
+    } // uHeapManager::setHugePages
+
+    bool uHeapManager::loadBuckets( const char *file ) {
+	// The bucket sizes are the union of the sizes in the file and the built-in sizes. While there are too many, the
+	// built-in size whose removal wastes the least storage (smallest ratio of the next size to the previous size) is
+	// removed. The largest built-in size is kept so every size below the mmap crossover has a bucket. Uses "open/read"
+	// and no storage because it is called while the heap is created, so a file that does not fit in the buffer is
+	// rejected.
+
+	char buf[4096];
+	int fd = ::open( file, O_RDONLY );
+      if ( fd == -1 ) return true;
+	size_t len = 0;
+	ssize_t rlen;
+	for ( ;; ) {					// read may return part of the file
+	    rlen = ::read( fd, buf + len, sizeof(buf) - len );
+	  if ( rlen <= 0 ) break;
+	    len += rlen;
+	  if ( len == sizeof(buf) ) break;		// file too large ?
+	} // for
+	::close( fd );
+      if ( rlen < 0 || len == sizeof(buf) ) return true; // read error or file too large ?
+	buf[len] = '\0';
+
+	enum { MaxSizes = 2 * NoBucketSizes };
+	unsigned int sizes[MaxSizes];
+	bool fixed[MaxSizes];				// size from the file or largest size => not removed
+	unsigned int n = 0;
+	for ( char *p = buf; *p != '\0'; ) {
+	    if ( *p == '#' ) {				// comment ?
+		while ( *p != '\0' && *p != '\n' ) p += 1;
+	    } else if ( *p == ' ' || *p == '\t' || *p == '\n' || *p == '\r' || *p == ',' ) {
+		p += 1;
+	    } else {
+		char *end;
+		unsigned long int size = strtoul( p, &end, 10 );
+	      if ( end == p ) return true;		// not a number ?
+		p = end;
+		size = uCeiling( std::max( size + sizeof(Storage::Header), (size_t)16 ), uAlign() ); // block for request
+	      if ( size >= bucketSizes[NoBucketSizes - 1] || n == NoBucketSizes - 1 ) return true;
+		sizes[n] = size;
+		fixed[n] = true;
+		n += 1;
+	    } // if
+	} // for
+      if ( n == 0 ) return true;
+
+	for ( unsigned int i = 0; i < NoBucketSizes; i += 1 ) { // add the built-in sizes
+	    sizes[n] = bucketSizes[i];
+	    fixed[n] = i == NoBucketSizes - 1;
+	    n += 1;
+	} // for
+	for ( unsigned int i = 1; i < n; i += 1 ) {	// insertion sort
+	    unsigned int size = sizes[i];
+	    bool keep = fixed[i];
+	    unsigned int j = i;
+	    for ( ; j > 0 && sizes[j - 1] > size; j -= 1 ) {
+		sizes[j] = sizes[j - 1];
+		fixed[j] = fixed[j - 1];
+	    } // for
+	    sizes[j] = size;
+	    fixed[j] = keep;
+	} // for
+	unsigned int u = 1;
+	for ( unsigned int i = 1; i < n; i += 1 ) {	// remove duplicates
+	    if ( sizes[i] == sizes[u - 1] ) {
+		fixed[u - 1] = fixed[u - 1] || fixed[i];
+	    } else {
+		sizes[u] = sizes[i];
+		fixed[u] = fixed[i];
+		u += 1;
+	    } // if
+	} // for
+	n = u;
+	while ( n > NoBucketSizes ) {			// too many sizes ?
+	    unsigned int victim = 0;
+	    double least = 0.0;
+	    for ( unsigned int i = 0; i < n; i += 1 ) {
+	      if ( fixed[i] ) continue;
+		double waste = (double)sizes[i + 1] / ( i == 0 ? (double)uAlign() : (double)sizes[i - 1] );
+		if ( least == 0.0 || waste < least ) {
+		    victim = i;
+		    least = waste;
+		} // if
+	    } // for
+	    for ( unsigned int i = victim; i < n - 1; i += 1 ) {
+		sizes[i] = sizes[i + 1];
+		fixed[i] = fixed[i + 1];
+	    } // for
+	    n -= 1;
+	} // while
+      if ( n < NoBucketSizes ) return true;		// cannot happen, as every built-in size is included
+
+	for ( unsigned int i = 0; i < NoBucketSizes; i += 1 ) {
+	    bucketSizes[i] = sizes[i];
+	} // for
+	customBuckets = true;
+	return false;
+    } // uHeapManager::loadBuckets
+
+
+    // On a NUMA machine, mallopt( M_NUMA_ARENAS, 1 ) gives each node an arena with its own free lists, and a processor
+    // whose affinity is confined to one node allocates from the arena of that node; other processors use the main heap.
+    // The node arenas are laid out in one reserved address range, each starting with its uHeapManager, so a bucket
+    // block is in an arena if its address is in the range, and its arena is found from its home free list. A block is
+    // always freed to its home arena. An arena grows by mapping the next part of its range and binding it to its node,
+    // and carves from the main heap when its range is exhausted.
+
+    bool uHeapManager::setNumaArenas( bool value ) {
+      if ( value && numaNodes <= 1 ) return true;	// not a NUMA machine ?
+	numaArenas = value;
+	uFetchAdd( arenaGeneration, 1 );		// processors rebind on their next allocation
+	return false;
+    } // uHeapManager::setNumaArenas
+
+    bool uHeapManager::setSampleRate( size_t value ) {
+#if defined( __linux__ )
+      if ( SampledBit == 0 ) return value != 0;	// no header bit to mark sampled blocks
+	if ( value != 0 && profile == NULL ) {
+	    // The first call to backtrace may allocate storage while loading the unwinder, so make it before sampling.
+	    void *stack[1];
+	    ::backtrace( stack, 1 );
+	} // if
+	heapManagerInstance->extlock.acquire();
+	if ( value != 0 && profile == NULL ) {
+	    void *storage = ::mmap( 0, uCeiling( sizeof(Profile), pageSize ), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, mmapFd, 0 );
+	    if ( storage == MAP_FAILED ) {
+		heapManagerInstance->extlock.release();
+		return true;
+	    } // if
+	    profile = (Profile *)storage;		// zero filled
+	} // if
+	if ( value != 0 ) profile->rate = value;
+	sampleRate = value;
+	uSigHandlerModule::heapProfileSignal( value != 0 ); // SIGUSR2 requests dumps only while sampling
+	heapManagerInstance->extlock.release();
+	return false;
+#else
+	return value != 0;
+#endif // __linux__
+    } // uHeapManager::setSampleRate
+
+
+    unsigned int uHeapManager::countNodes() {
+	// Count the nodes and record the node of each CPU from the node's CPU list, e.g., "0-7,16-23". Called during heap
+	// initialization, so the files are read without allocating storage.
+
+	memset( cpuNodes, NoNumaNode, sizeof(cpuNodes) );
+#if defined( __linux__ ) && __U_WORDSIZE__ == 64
+	char path[64], list[1024];
+	unsigned int nodes = 0;
+	for ( ; nodes < MaxNumaNodes; nodes += 1 ) {
+	    snprintf( path, sizeof(path), "/sys/devices/system/node/node%u/cpulist", nodes );
+	    int fd = ::open( path, O_RDONLY );
+	  if ( fd == -1 ) break;
+	    ssize_t len = ::read( fd, list, sizeof(list) - 1 );
+	    ::close( fd );
+	    if ( len < 0 ) len = 0;
+	    list[len] = '\0';
+	    for ( char *p = list; *p >= '0' && *p <= '9'; ) {
+		unsigned long int first = strtoul( p, &p, 10 ), last = first;
+		if ( *p == '-' ) last = strtoul( p + 1, &p, 10 );
+		for ( unsigned long int cpu = first; cpu <= last && cpu < MaxNumaCpus; cpu += 1 ) {
+		    cpuNodes[cpu] = nodes;
+		} // for
+		if ( *p == ',' ) p += 1;
+	    } // for
+	} // for
+	return nodes;
+#else
+	return 0;					// too little address space to reserve arenas
+#endif // __linux__ && __U_WORDSIZE__ == 64
+    } // uHeapManager::countNodes
+
+    int uHeapManager::currentNode() {
+	// A processor belongs to a node if every CPU in the affinity set of its kernel thread is on that node. Otherwise,
+	// the operating system may move the thread between nodes, so the node it happens to run on now is not a useful
+	// arena, and -1 is returned to allocate from the main heap. Affinity changes rebind the arena.
+#if defined( __linux__ )
+	cpu_set_t mask;
+      if ( sched_getaffinity( 0, sizeof(mask), &mask ) != 0 ) return -1; // calling kernel thread
+	int node = -1;
+	for ( unsigned int cpu = 0; cpu < CPU_SETSIZE; cpu += 1 ) {
+	  if ( ! CPU_ISSET( cpu, &mask ) ) continue;
+	  if ( cpu >= MaxNumaCpus || cpuNodes[cpu] == NoNumaNode || cpuNodes[cpu] >= numaNodes ) return -1;
+	  if ( node != -1 && node != cpuNodes[cpu] ) return -1; // spans nodes ?
+	    node = cpuNodes[cpu];
+	} // for
+	return node;
+#else
+	return -1;
+#endif // __linux__
+    } // uHeapManager::currentNode
+
+    // Map storage in the reserved range for a node arena and prefer pages from that node.
+    static bool mapNode( char *addr, size_t size, unsigned int node ) {
+#if defined( __linux__ )
+	if ( ::mmap( addr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0 ) == MAP_FAILED ) return false;
+#if defined( SYS_mbind )
+	unsigned long int mask = 1UL << node;
+	syscall( SYS_mbind, addr, size, MPOL_PREFERRED, &mask, sizeof(mask) * 8 + 1, 0 ); // failure => first touch
+#endif // SYS_mbind
+	return true;
+#else
+	return false;
+#endif // __linux__
+    } // mapNode
+
+    uHeapManager *uHeapManager::nodeArena( unsigned int node ) {
+	uHeapManager *arena = arenas[node];
+      if ( likely( arena != NULL ) ) return arena;
+
+	uHeapManager *heap = heapManagerInstance;
+	heap->extlock.acquire();
+	if ( numaSpan == 0 ) {				// first node arena ?
+#if __U_WORDSIZE__ == 64
+	    size_t reserve = 64UL * 1024 * 1024 * 1024;	// address space only, pages are mapped as an arena grows
+	    void *base = ::mmap( 0, numaNodes * reserve, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0 );
+	    if ( base != MAP_FAILED ) {
+		numaBase = (char *)base;
+		numaReserve = reserve;
+		numaSpan = numaNodes * reserve;
+	    } // if
+#endif // __U_WORDSIZE__ == 64
+	} // if
+	if ( numaSpan != 0 && arenas[node] == NULL ) {
+	    char *region = numaBase + node * numaReserve;
+	    size_t size = uCeiling( sizeof(uHeapManager), pageSize );
+	    if ( mapNode( region, size, node ) ) {
+		arenas[node] = new( region ) uHeapManager( node, region + size, region + numaReserve );
+	    } // if
+	} // if
+	arena = arenas[node];
+	heap->extlock.release();
+	return arena != NULL ? arena : heap;		// no address space => single heap
+    } // uHeapManager::nodeArena
+
+    inline uHeapManager *uHeapManager::arenaOf( FreeHeader *freeElem ) {
+	uintptr_t offset = (uintptr_t)freeElem - (uintptr_t)heapManagerInstance->freeLists;
+      if ( likely( offset < sizeof(heapManagerInstance->freeLists) || numaSpan == 0 ) ) return heapManagerInstance;
+	return (uHeapManager *)( numaBase + ( (uintptr_t)freeElem - (uintptr_t)numaBase ) / numaReserve * numaReserve );
+    } // uHeapManager::arenaOf
+
+    inline bool uHeapManager::inArena( void *addr ) {
+	return (uintptr_t)addr - (uintptr_t)numaBase < numaSpan;
+    } // uHeapManager::inArena
+
     inline bool uHeapManager::headers( const char *name, void *addr, Storage::Header *&header, FreeHeader *&freeElem, size_t &size, size_t &alignment ) {
 	header = (Storage::Header *)( (char *)addr - sizeof(Storage::Header) );
 	if ( unlikely( (header->kind.fake.alignment & 1) == 1 ) ) { // fake header ?
@@ -171,13 +602,14 @@ namespace UPP {
 #endif // __U_DEBUG__
 	    header = (Storage::Header *)((char *)header - offset);
 	} // if
-	if ( unlikely( addr < heapBegin || heapEnd < addr ) ) {	// mmapped ?
-	    size = header->kind.real.blockSize & -3;
+	if ( unlikely( ( addr < heapBegin || heapEnd < addr ) && ! inArena( addr ) ) ) { // mmapped ?
+	    size = header->kind.real.blockSize & ~(size_t)HeaderFlags;
 	    return true;
 	} else {
-	    freeElem = (FreeHeader *)((size_t)header->kind.real.home & -3);
+	    freeElem = (FreeHeader *)((size_t)header->kind.real.home & ~(size_t)HeaderFlags);
 #ifdef __U_DEBUG__
-	    if ( freeElem < &freeLists[0] || &freeLists[NoBucketSizes] <= freeElem ) {
+	    uHeapManager *arena = arenaOf( freeElem );
+	    if ( freeElem < &arena->freeLists[0] || &arena->freeLists[NoBucketSizes + NoAlignedSizes] <= freeElem ) {
 		uAbort( "Attempt to %s storage %p with corrupted header.\n"
 			"Possible cause is duplicate free on same block or overwriting of header information.",
 			name, addr );
@@ -200,7 +632,37 @@ namespace UPP {
 	    // If the size requested is bigger than the current remaining storage, increase the size of the heap.
 
 	    size_t increase = uCeiling( size > heapExpand ? size : heapExpand, uAlign() );
-	    if ( sbrk( increase ) == (void *)-1 ) {
+	    char *top = (char *)heapEnd + heapRemaining; // current brk or mapped end of node arena
+	    if ( heapLimit != NULL ) increase = uCeiling( increase, pageSize ); // node arena is mapped in pages
+	    if ( hugePages != HugeNone ) {		// end the heap on a huge-page boundary so huge pages can back it
+		increase = (char *)uCeiling( (uintptr_t)top + increase, HugePageSize ) - top;
+	    } // if
+	    if ( heapLimit != NULL && ( top + increase > heapLimit || ! mapNode( top, increase, node ) ) ) {
+		// The node's address space is exhausted or cannot be mapped, so carve the block from the main heap. The
+		// block is still given to the node arena's free lists, and it is found there when freed because blocks
+		// in the main heap are located by their home free list.
+		extlock.release();
+#ifdef __U_STATISTICS__
+		uFetchAdd( numa_fallbacks, 1 );
+#endif // __U_STATISTICS__
+		return heapManagerInstance->extend( size );
+	    } // if
+	    char *prev = heapLimit == NULL ? (char *)sbrk( increase ) : top;
+	    if ( unlikely( prev != top && prev != (char *)-1 ) ) { // brk moved outside the heap ?
+		// The new storage does not follow the remaining storage, so the remainder is discarded and the heap
+		// continues at the new storage, aligned. If the alignment leaves too little storage, the brk is advanced
+		// again, which must be contiguous with the new storage.
+		char *start = (char *)uCeiling( (uintptr_t)prev, uAlign() );
+		bool more = (size_t)( prev + increase - start ) < size;
+		if ( more && (char *)sbrk( uAlign() ) != prev + increase ) {
+		    prev = (char *)-1;			// no storage
+		} else {
+		    increase = prev + increase + ( more ? uAlign() : 0 ) - start;
+		    heapEnd = top = start;
+		    heapRemaining = 0;
+		} // if
+	    } // if
+	    if ( prev == (char *)-1 ) {
 #ifdef __U_DEBUG_H__
 		uDebugPrt( "0x%zx = (uHeapManager &)%p.extend( %zu ), heapBegin:%p, heapEnd:%p, heapRemaining:0x%zx, sbrk:%p\n",
 			   NULL, this, size, heapBegin, heapEnd, heapRemaining, sbrk(0) );
@@ -210,9 +672,24 @@ namespace UPP {
 		return NULL;
 	    } // if
 #ifdef __U_STATISTICS__
-	    sbrk_calls += 1;
-	    sbrk_storage += increase;
+	    if ( heapLimit == NULL ) {
+		sbrk_calls += 1;
+		sbrk_storage += increase;
+	    } else {
+		uFetchAdd( numa_calls, 1 );
+		uFetchAdd( numa_storage, increase );
+	    } // if
+#endif // __U_STATISTICS__
+#ifdef MADV_HUGEPAGE
+	    if ( hugePages != HugeNone ) {
+		char *start = (char *)uCeiling( (uintptr_t)top, pageSize );
+		if ( ::madvise( start, top + increase - start, MADV_HUGEPAGE ) == 0 ) {
+#ifdef __U_STATISTICS__
+		    uFetchAdd( huge_advise_storage, top + increase - start );
 #endif // __U_STATISTICS__
+		} // if
+	    } // if
+#endif // MADV_HUGEPAGE
 #ifdef __U_DEBUG__
 	    // Set new memory to garbage so subsequent uninitialized usages might fail.
 	    memset( (char *)heapEnd + heapRemaining, '\377', increase );
@@ -232,9 +709,600 @@ namespace UPP {
     } // uHeapManager::extend
 
 
-    inline void *uHeapManager::doMalloc( size_t size ) {
+    inline uHeapManager::FreeHeader *uHeapManager::alignedClass( size_t alignment, size_t size ) {
+	// Return the smallest aligned size class for the alignment and size, or NULL if there is none.
+
+	for ( unsigned int a = 0; a < NoAlignments; a += 1 ) {
+	  if ( alignment != alignments[a] ) continue;
+	    size_t tsize = size + sizeof(Storage::Header);
+	    for ( unsigned int i = 0; i < AlignedMultiples; i += 1 ) {
+		FreeHeader *freeElem = &freeLists[NoBucketSizes + a * AlignedMultiples + i];
+	      if ( freeElem->blockSize >= mmapStart ) break; // large size => mmap
+		if ( tsize <= freeElem->blockSize ) return freeElem;
+	    } // for
+	    break;
+	} // for
+	return NULL;
+    } // uHeapManager::alignedClass
+
+
+    size_t uHeapManager::classAlignment( FreeHeader *freeElem ) {
+	// Return the alignment of an aligned size class, or 0 for a bucket.
+
+	unsigned int i = freeElem - arenaOf( freeElem )->freeLists;
+      if ( i < NoBucketSizes ) return 0;
+	return alignments[(i - NoBucketSizes) / AlignedMultiples];
+    } // uHeapManager::classAlignment
+
+
+    void *uHeapManager::extendAligned( FreeHeader *freeElem ) {
+	// Carve a batch of blocks for an aligned size class, returning the first and pushing the rest on the free list.
+	// Aligning the user storage of the first block aligns them all; the padding before the first block is unused.
+
+	size_t size = freeElem->blockSize, alignment = classAlignment( freeElem );
+	unsigned int n = RegionChunk / size;
+	if ( n == 0 ) n = 1;
+	if ( n > CacheBatch ) n = CacheBatch;
+	char *area = (char *)extend( size * n + alignment - uAlign() );
+	if ( area == NULL ) {
+	    n = 1;
+	    area = (char *)extend( size + alignment - uAlign() ); // insufficient storage for a batch ?
+	  if ( area == NULL ) return NULL;
+	} // if
+	char *first = (char *)uCeiling( (uintptr_t)area + sizeof(Storage::Header), alignment ) - sizeof(Storage::Header);
+
+	if ( n > 1 ) {
+	    char *p = first + size;
+	    for ( unsigned int i = 2; i < n; i += 1, p += size ) { // link blocks
+		((Storage *)p)->header.kind.real.next = (Storage *)(p + size);
+	    } // for
+	    freeElem->lock.acquire();
+	    ((Storage *)p)->header.kind.real.next = freeElem->freeList;
+	    freeElem->freeList = (Storage *)(first + size);
+	    freeElem->lock.release();
+	} // if
+	return first;
+    } // uHeapManager::extendAligned
+
+
+    // Map storage for a large block, rounding tsize up to the mapped size. With huge pages, blocks of at least a huge
+    // page are sized and aligned to huge pages, first trying MAP_HUGETLB if requested and otherwise over-mapping to find
+    // an aligned address and advising MADV_HUGEPAGE. Smaller blocks gain nothing from huge pages.
+    inline uHeapManager::Storage *uHeapManager::mmapBlock( size_t &tsize ) {
+	int mmapFlags = MAP_PRIVATE |
+#if defined( __freebsd__ )
+	    MAP_ANON;
+#else
+	    MAP_ANONYMOUS;
+#endif
+	if ( hugePages == HugeNone || tsize < HugePageSize ) {
+	    tsize = uCeiling( tsize, pageSize );	// must be multiple of page size
+	    return (Storage *)::mmap( 0, tsize, PROT_READ | PROT_WRITE, mmapFlags, mmapFd, 0 );
+	} // if
+
+	tsize = uCeiling( tsize, HugePageSize );
+#ifdef MAP_HUGETLB
+	if ( hugePages == HugeTLB ) {
+	    void *block = ::mmap( 0, tsize, PROT_READ | PROT_WRITE, mmapFlags | MAP_HUGETLB, mmapFd, 0 );
+	    if ( block != MAP_FAILED ) {
+#ifdef __U_STATISTICS__
+		uFetchAdd( huge_tlb_storage, tsize );
+#endif // __U_STATISTICS__
+		return (Storage *)block;
+	    } // if
+	    // no reserved huge pages available => fall back to transparent huge pages
+	} // if
+#endif // MAP_HUGETLB
+
+	size_t msize = tsize + HugePageSize - pageSize;	// room to align the start
+	char *area = (char *)::mmap( 0, msize, PROT_READ | PROT_WRITE, mmapFlags, mmapFd, 0 );
+      if ( area == MAP_FAILED ) return (Storage *)MAP_FAILED;
+	char *block = (char *)uCeiling( (uintptr_t)area, HugePageSize );
+	if ( block != area ) ::munmap( area, block - area ); // remove unaligned prefix and suffix
+	if ( block + tsize != area + msize ) ::munmap( block + tsize, area + msize - ( block + tsize ) );
+#ifdef MADV_HUGEPAGE
+	if ( ::madvise( block, tsize, MADV_HUGEPAGE ) == 0 ) {
+#ifdef __U_STATISTICS__
+	    uFetchAdd( huge_advise_storage, tsize );
+#endif // __U_STATISTICS__
+	} // if
+#endif // MADV_HUGEPAGE
+	return (Storage *)block;
+    } // uHeapManager::mmapBlock
+
+
+    inline uHeapManager::ProcessorCache *uHeapManager::processorCache() {
+	// Interrupts are disabled by the caller. No cache is used during boot and after a processor terminates.
+
+	uProcessor *processor = THREAD_GETMEM( activeProcessor );
+      if ( unlikely( processor == NULL || processor->terminated ) ) return NULL;
+	ProcessorCache *cache = (ProcessorCache *)processor->heapData;
+	if ( unlikely( cache == NULL ) ) {		// first allocation on processor ?
+	    extlock.acquire();
+	    cache = spareCaches;
+	    if ( cache != NULL ) spareCaches = cache->next;
+	    extlock.release();
+	    if ( cache == NULL ) {
+		cache = (ProcessorCache *)extend( uCeiling( sizeof(ProcessorCache), uAlign() ) );
+	      if ( cache == NULL ) return NULL;
+		memset( cache, '\0', sizeof(ProcessorCache) );
+#ifdef __U_STATISTICS__
+		extlock.acquire();
+		cache->nextCache = allCaches;
+		allCaches = cache;
+		extlock.release();
+#endif // __U_STATISTICS__
+	    } else {
+#ifdef __U_STATISTICS__
+		ProcessorCache *nextCache = cache->nextCache;
+#endif // __U_STATISTICS__
+		memset( cache, '\0', sizeof(ProcessorCache) );
+#ifdef __U_STATISTICS__
+		cache->nextCache = nextCache;
+#endif // __U_STATISTICS__
+	    } // if
+	    processor->heapData = cache;
+	} // if
+	if ( unlikely( cache->generation != arenaGeneration ) ) bindArena( cache );
+	return cache;
+    } // uHeapManager::processorCache
+
+
+    void uHeapManager::bindArena( ProcessorCache *cache ) {
+	// Return the cached blocks to the arena they came from, and bind the cache to the arena the processor allocates
+	// from. Interrupts are disabled by the caller.
+
+	uHeapManager *arena = cache->arena;
+	if ( arena != NULL ) {
+	    for ( unsigned int i = 0; i < NoBucketSizes + NoAlignedSizes; i += 1 ) {
+		arena->cacheFlush( &arena->freeLists[i], cache->buckets[i], cache->buckets[i].count );
+	    } // for
+	} // if
+	cache->generation = arenaGeneration;
+	int node = numaArenas ? currentNode() : -1;
+	cache->arena = node != -1 ? nodeArena( node ) : heapManagerInstance;
+    } // uHeapManager::bindArena
+
+
+    bool uHeapManager::cacheRefill( FreeHeader *freeElem, ProcessorCache::Bucket &bucket ) {
+	// Move a batch of blocks from the free list to the empty cache bucket, or carve a batch from the heap if the free
+	// list is empty. An aligned size class is carved by extendAligned, which leaves the rest of its batch on the free
+	// list for the next refill.
+
+	Storage *head, *last = NULL;
+	unsigned int n = 0;
+
+	freeElem->lock.acquire();
+	head = freeElem->freeList;
+	for ( Storage *p = head; p != NULL && n < CacheBatch; p = p->header.kind.real.next ) {
+	    last = p;
+	    n += 1;
+	} // for
+	if ( n != 0 ) freeElem->freeList = last->header.kind.real.next;
+	freeElem->lock.release();
+
+	if ( n == 0 && classAlignment( freeElem ) != 0 ) {
+	    head = last = (Storage *)extendAligned( freeElem );
+	  if ( head == NULL ) return false;
+	    n = 1;
+	} else if ( n == 0 ) {
+	    size_t size = freeElem->blockSize;
+	    char *area = (char *)extend( size * CacheBatch );
+	    if ( area != NULL ) {
+		n = CacheBatch;
+	    } else {
+		area = (char *)extend( size );		// insufficient storage for a batch ?
+	      if ( area == NULL ) return false;
+		n = 1;
+	    } // if
+	    head = (Storage *)area;
+	    for ( unsigned int i = 1; i < n; i += 1 ) {	// link blocks
+		((Storage *)area)->header.kind.real.next = (Storage *)(area + size);
+		area += size;
+	    } // for
+	    last = (Storage *)area;
+	} // if
+
+	last->header.kind.real.next = NULL;
+	bucket.freeList = head;
+	bucket.count = n;
+#ifdef __U_STATISTICS__
+	uFetchAdd( cache_alloc_refills, 1 );
+#endif // __U_STATISTICS__
+	return true;
+    } // uHeapManager::cacheRefill
+
+
+    unsigned int uHeapManager::cacheFlush( FreeHeader *freeElem, ProcessorCache::Bucket &bucket, unsigned int n ) {
+	// Move the first n blocks of the cache bucket to the free list, and return the number moved.
+
+      if ( n == 0 || bucket.freeList == NULL ) return 0;
+	Storage *head = bucket.freeList, *last = head;
+	unsigned int moved = 1;
+	for ( ; moved < n && last->header.kind.real.next != NULL; moved += 1 ) {
+	    last = last->header.kind.real.next;
+	} // for
+	bucket.freeList = last->header.kind.real.next;
+	bucket.count -= moved;
+
+	freeElem->lock.acquire();
+	last->header.kind.real.next = freeElem->freeList;
+	freeElem->freeList = head;
+	freeElem->lock.release();
+#ifdef __U_STATISTICS__
+	uFetchAdd( cache_free_flushes, 1 );
+#endif // __U_STATISTICS__
+	return moved;
+    } // uHeapManager::cacheFlush
+
+
+    // Region chunks are carved from the heap extension area and linked through their first word when spare. They never
+    // enter the free lists, so regions do not contend on bucket locks.
+
+    void *uHeapManager::regionChunk() {
+	extlock.acquire();
+	void *chunk = spareChunks;
+	if ( chunk != NULL ) {
+	    spareChunks = *(void **)chunk;
+	    spareChunkCount -= 1;
+	} // if
+	extlock.release();
+	if ( chunk != NULL ) {
+#ifdef __U_STATISTICS__
+	    uFetchAdd( region_reuses, 1 );
+#endif // __U_STATISTICS__
+	    return chunk;
+	} // if
+#ifdef __U_STATISTICS__
+	uFetchAdd( region_chunks, 1 );
+#endif // __U_STATISTICS__
+	return extend( RegionChunk );
+    } // uHeapManager::regionChunk
+
+
+    void uHeapManager::regionRelease( void *first, void *last ) {
+	// The chunks from first to last are linked through their first word. A few spare chunks are kept for regions, and
+	// the others are divided into free blocks of the largest bucket size that fits a chunk, so their storage can be
+	// reused by malloc or returned to the operating system by trim.
+
+	unsigned int n = 1;
+	for ( void *c = first; c != last; c = *(void **)c ) n += 1;
+
+	void *excess = NULL;
+	extlock.acquire();
+	*(void **)last = spareChunks;
+	spareChunks = first;
+	spareChunkCount += n;
+	for ( ; spareChunkCount > RegionSpares; spareChunkCount -= 1 ) {
+	    void *chunk = spareChunks;
+	    spareChunks = *(void **)chunk;
+	    *(void **)chunk = excess;
+	    excess = chunk;
+	} // for
+	extlock.release();
+      if ( excess == NULL ) return;
+
+	FreeHeader key;
+	key.blockSize = RegionChunk;
+	FreeHeader *freeElem = std::upper_bound( freeLists, freeLists + maxBucketsUsed, key ) - 1; // largest bucket not above a chunk
+	size_t size = freeElem->blockSize;
+	unsigned int blocks = RegionChunk / size;
+	for ( void *chunk = excess; chunk != NULL; ) {
+	    void *nextChunk = *(void **)chunk;
+	    char *area = (char *)chunk;
+	    for ( unsigned int i = 1; i < blocks; i += 1, area += size ) { // link blocks
+		((Storage *)area)->header.kind.real.next = (Storage *)(area + size);
+	    } // for
+	    if ( size >= 2 * pageSize ) {		// clear trim marks
+		for ( char *p = (char *)chunk; p <= area; p += size ) *(uintptr_t *)((Storage *)p)->data = 0;
+	    } // if
+	    freeElem->lock.acquire();
+	    ((Storage *)area)->header.kind.real.next = freeElem->freeList;
+	    freeElem->freeList = (Storage *)chunk;
+	    freeElem->lock.release();
+#ifdef __U_STATISTICS__
+	    uFetchAdd( region_frees, 1 );
+#endif // __U_STATISTICS__
+	    freed( blocks * size );
+	    chunk = nextChunk;
+	} // for
+    } // uHeapManager::regionRelease
+
+
+    // A free block spanning whole pages has those pages released to the operating system, except the page holding its
+    // header and free-list link. The first data word of a released block is marked so a later trim skips the block; the
+    // mark is cleared when the block is allocated.
+
+    enum { TrimMark = 0x5a5a5a5a };
+
+    uHeapManager::Storage *uHeapManager::sortDescending( Storage *list ) {
+	// Merge sort a free list by address, highest first, without allocating storage.
+
+      if ( list == NULL || list->header.kind.real.next == NULL ) return list;
+	Storage *slow = list, *fast = list->header.kind.real.next;
+	while ( fast != NULL && fast->header.kind.real.next != NULL ) { // split at middle
+	    slow = slow->header.kind.real.next;
+	    fast = fast->header.kind.real.next->header.kind.real.next;
+	} // while
+	Storage *second = slow->header.kind.real.next;
+	slow->header.kind.real.next = NULL;
+	Storage *l = sortDescending( list ), *r = sortDescending( second ), *head = NULL, **tail = &head;
+	while ( l != NULL && r != NULL ) {
+	    Storage **higher = l > r ? &l : &r;
+	    *tail = *higher;
+	    tail = &(*higher)->header.kind.real.next;
+	    *higher = *tail;
+	} // while
+	*tail = l != NULL ? l : r;
+	return head;
+    } // uHeapManager::sortDescending
+
+
+    size_t uHeapManager::trim( size_t pad ) {
+	size_t released = 0, madvised = 0;
+
+	// The free list is detached while its blocks are advised, so madvise is not called holding the free-list lock and
+	// no block can be allocated while its pages are released. Allocations during the detachment extend the heap.
+	for ( unsigned int i = 0; i < maxBucketsUsed; i += 1 ) {
+	    FreeHeader &freeElem = freeLists[i];
+	  if ( freeElem.blockSize < 2 * pageSize ) continue; // cannot span a page beyond the header page
+	    freeElem.lock.acquire();
+	    Storage *list = freeElem.freeList;
+	    freeElem.freeList = NULL;
+	    freeElem.lock.release();
+	  if ( list == NULL ) continue;
+
+	    Storage *last = NULL;
+	    for ( Storage *p = list; p != NULL; p = p->header.kind.real.next ) {
+		last = p;
+		uintptr_t *mark = (uintptr_t *)p->data;
+	      if ( *mark == ((uintptr_t)p ^ TrimMark) ) continue; // already released ?
+		char *start = (char *)uCeiling( (uintptr_t)(mark + 1), pageSize );
+		char *end = (char *)uFloor( (uintptr_t)p + freeElem.blockSize, pageSize );
+		if ( start < end && ::madvise( start, end - start, MADV_DONTNEED ) == 0 ) {
+		    madvised += end - start;
+		    *mark = (uintptr_t)p ^ TrimMark;
+		} // if
+	    } // for
+
+	    freeElem.lock.acquire();
+	    last->header.kind.real.next = freeElem.freeList; // blocks freed meanwhile
+	    freeElem.freeList = list;
+	    freeElem.lock.release();
+	} // for
+	released += madvised;
+
+	extlock.acquire();
+	// Return free blocks at the end of the heap to the unallocated remainder. Only blocks of a page or more are
+	// considered, which bounds the search. Sorting the lists by address puts the blocks nearest the end of the heap at
+	// the list heads, so each block returned only checks the list heads rather than rescanning the lists.
+	for ( unsigned int i = 0; i < maxBucketsUsed; i += 1 ) {
+	    FreeHeader &freeElem = freeLists[i];
+	  if ( freeElem.blockSize < pageSize ) continue;
+	    freeElem.lock.acquire();
+	    freeElem.freeList = sortDescending( freeElem.freeList );
+	    freeElem.lock.release();
+	} // for
+	for ( bool found = true; found; ) {
+	    found = false;
+	    for ( unsigned int i = 0; i < maxBucketsUsed; i += 1 ) {
+		FreeHeader &freeElem = freeLists[i];
+	      if ( freeElem.blockSize < pageSize ) continue;
+		freeElem.lock.acquire();
+		Storage *top = freeElem.freeList;
+		if ( top != NULL && (char *)top + freeElem.blockSize == heapEnd ) { // block at end of heap ?
+		    freeElem.freeList = top->header.kind.real.next;
+		    heapEnd = top;
+		    heapRemaining += freeElem.blockSize;
+		    found = true;
+		} // if
+		freeElem.lock.release();
+	    } // for
+	} // for
+
+	// Shrink the heap, keeping pad bytes, unless some other code has moved the break. A node arena keeps its
+	// remainder mapped and bound to its node, but releases the pages.
+	size_t sbrked = 0;
+	if ( heapLimit != NULL ) {
+	    char *start = (char *)uCeiling( (uintptr_t)heapEnd + pad, pageSize ), *end = (char *)heapEnd + heapRemaining;
+	    if ( start < end && ::madvise( start, end - start, MADV_DONTNEED ) == 0 ) {
+		madvised += end - start;
+		released += end - start;
+	    } // if
+	} else if ( heapRemaining > pad && (char *)sbrk( 0 ) == (char *)heapEnd + heapRemaining ) {
+	    size_t excess = uFloor( heapRemaining - pad, pageSize );
+	    if ( excess != 0 && sbrk( -(ptrdiff_t)excess ) != (void *)-1 ) {
+		heapRemaining -= excess;
+		sbrked = excess;
+	    } // if
+	} // if
+	extlock.release();
+	released += sbrked;
+
+#ifdef __U_STATISTICS__
+	uFetchAdd( trim_calls, 1 );
+	uFetchAdd( trim_madvise_storage, madvised );
+	uFetchAdd( trim_sbrk_storage, sbrked );
+#endif // __U_STATISTICS__
+	return released;
+    } // uHeapManager::trim
+
+
+    static size_t sampleInterval( unsigned int &seed, size_t rate ) {
+	// Exponentially distributed with mean rate, so the samples are a Poisson process over the allocated bytes as the
+	// pprof heap_v2 format assumes. The log2 of the uniform random value uses a quadratic fit of the mantissa.
+
+	seed ^= seed << 13;				// xorshift
+	seed ^= seed >> 17;
+	seed ^= seed << 5;
+	unsigned int q = ( seed >> 6 ) + 1;		// 1 .. 2^26
+	int shift = __builtin_clz( q );
+	double mantissa = (double)( ( q << shift ) << 1 ) / 4294967296.0; // [0,1)
+	double log2q = 31 - shift + mantissa * ( 1.3466 - 0.3466 * mantissa );
+	return (size_t)( ( 26.0 - log2q ) * 0.6931471805599453 * rate ) + 1;
+    } // sampleInterval
+
+
+    __attribute__(( noinline )) void uHeapManager::sample( Storage *block, size_t size ) {
+	// Count the allocation against the processor's countdown and record its call stack when the countdown expires. Not
+	// inlined, so only this routine's frame is dropped from the backtrace.
+
+      if ( unlikely( profile == NULL ) ) return;	// sampling not started (boot)
+	ProcessorCache *cache = NULL;			// cache whose countdown expired
+	THREAD_GETMEM( This )->disableInterrupts();
+	ProcessorCache *current = processorCache();
+	if ( likely( current != NULL && ! current->sampling ) ) {
+	    if ( unlikely( current->sampleSeed == 0 ) ) { // first allocation counted on processor ?
+		current->sampleSeed = (unsigned int)( (uintptr_t)current >> 4 ) | 1;
+		current->sampleCountdown = sampleInterval( current->sampleSeed, sampleRate );
+	    } // if
+	    if ( likely( current->sampleCountdown > size ) ) {
+		current->sampleCountdown -= size;
+	    } else {
+		current->sampleCountdown = sampleInterval( current->sampleSeed, sampleRate );
+		current->sampling = true;		// allocations by backtrace are not sampled
+		cache = current;
+	    } // if
+	} // if
+	THREAD_GETMEM( This )->enableInterrupts();
+
+	if ( unlikely( cache != NULL ) ) {		// record sample ?
+	    // The unwinder may block or take a long time, so the call stack is recorded with interrupts enabled. The task
+	    // may then migrate, so the flag is reset in the cache that set it.
+	    void *stack[SampleDepth + 1];
+	    unsigned int depth = ::backtrace( stack, SampleDepth + 1 ) - 1; // drop this routine
+	    size_t hash = depth;
+	    for ( unsigned int i = 1; i <= depth; i += 1 ) {
+		hash = hash * 31 + ( (uintptr_t)stack[i] >> 2 );
+	    } // for
+
+	    profile->lock.acquire();
+	    Profile::Site *site;
+	    for ( site = profile->siteHash[hash % SampleSites]; site != NULL; site = site->next ) {
+	      if ( site->hash == hash && site->depth == depth && memcmp( site->stack, &stack[1], depth * sizeof(void *) ) == 0 ) break;
+	    } // for
+	    if ( site == NULL && profile->usedSites < SampleSites ) { // new call site ?
+		site = &profile->sites[profile->usedSites];
+		profile->usedSites += 1;
+		site->hash = hash;
+		site->depth = depth;
+		memcpy( site->stack, &stack[1], depth * sizeof(void *) );
+		site->next = profile->siteHash[hash % SampleSites];
+		profile->siteHash[hash % SampleSites] = site;
+	    } // if
+	    Profile::Sample *entry = profile->freeSamples;
+	    if ( entry != NULL ) {
+		profile->freeSamples = entry->next;
+	    } else if ( profile->usedSamples < SampleBlocks ) {
+		entry = &profile->samples[profile->usedSamples];
+		profile->usedSamples += 1;
+	    } // if
+	    if ( unlikely( site == NULL || entry == NULL ) ) { // table full ?
+		if ( entry != NULL ) {
+		    entry->next = profile->freeSamples;
+		    profile->freeSamples = entry;
+		} // if
+		profile->dropped += 1;
+	    } else {
+		entry->header = &block->header;
+		entry->site = site;
+		entry->size = size;
+		Profile::Sample *&bucket = profile->sampleHash[( (uintptr_t)&block->header >> 4 ) % SampleBlocks];
+		entry->next = bucket;
+		bucket = entry;
+		site->allocCount += 1;
+		site->allocBytes += size;
+		site->liveCount += 1;
+		site->liveBytes += size;
+		block->header.kind.real.blockSize |= SampledBit; // mark as sampled
+	    } // if
+	    profile->lock.release();
+	    cache->sampling = false;
+	} // if
+
+	if ( unlikely( profileRequested ) ) {		// dump requested by signal ?
+	    profileRequested = false;
+	    malloc_profile();
+	} // if
+    } // uHeapManager::sample
+
+
+    void uHeapManager::unsample( Storage::Header *header ) {
+	// Remove the sample of a block that is freed or moved.
+
+	profile->lock.acquire();
+	Profile::Sample **prev = &profile->sampleHash[( (uintptr_t)header >> 4 ) % SampleBlocks];
+	while ( *prev != NULL && (*prev)->header != header ) prev = &(*prev)->next;
+	Profile::Sample *entry = *prev;
+	if ( entry != NULL ) {
+	    *prev = entry->next;
+	    entry->site->liveCount -= 1;
+	    entry->site->liveBytes -= entry->size;
+	    entry->next = profile->freeSamples;
+	    profile->freeSamples = entry;
+	} // if
+	profile->lock.release();
+	header->kind.real.blockSize &= ~(size_t)SampledBit;
+    } // uHeapManager::unsample
+
+
+    void uHeapManager::profileDump( int fd ) {
+	// Write the profile in the legacy heap-profile text format read by pprof: the totals and sampling rate, a line per
+	// call site with its live and sampled blocks, and the memory map to symbolize the addresses. The profile lock is
+	// held by the caller. Use "write" because streams may be shutdown when calls are made.
+
+	char helpText[SampleDepth * 20 + 128];
+	unsigned long long int liveCount = 0, liveBytes = 0, allocCount = 0, allocBytes = 0;
+	for ( unsigned int i = 0; i < profile->usedSites; i += 1 ) {
+	    liveCount += profile->sites[i].liveCount;
+	    liveBytes += profile->sites[i].liveBytes;
+	    allocCount += profile->sites[i].allocCount;
+	    allocBytes += profile->sites[i].allocBytes;
+	} // for
+	int len = snprintf( helpText, sizeof(helpText), "heap profile: %llu: %llu [%llu: %llu] @ heap_v2/%zu\n",
+			    liveCount, liveBytes, allocCount, allocBytes, profile->rate );
+	uDebugWrite( fd, helpText, len );
+
+	for ( unsigned int i = 0; i < profile->usedSites; i += 1 ) {
+	    Profile::Site &site = profile->sites[i];
+	    len = snprintf( helpText, sizeof(helpText), "%llu: %llu [%llu: %llu] @",
+			    site.liveCount, site.liveBytes, site.allocCount, site.allocBytes );
+	    for ( unsigned int f = 0; f < site.depth; f += 1 ) {
+		len += snprintf( helpText + len, sizeof(helpText) - len, " %p", site.stack[f] );
+	    } // for
+	    helpText[len] = '\n';
+	    uDebugWrite( fd, helpText, len + 1 );
+	} // for
+
+	len = snprintf( helpText, sizeof(helpText), "\nMAPPED_LIBRARIES:\n" );
+	uDebugWrite( fd, helpText, len );
+	int maps = ::open( "/proc/self/maps", O_RDONLY );
+	if ( maps != -1 ) {
+	    for ( ;; ) {
+		ssize_t size = ::read( maps, helpText, sizeof(helpText) );
+	      if ( size <= 0 ) break;
+		uDebugWrite( fd, helpText, size );
+	    } // for
+	    ::close( maps );
+	} // if
+    } // uHeapManager::profileDump
+
+
+    inline void uHeapManager::freed( size_t size ) {
+	// Trim when enough storage has been returned to the free lists since the last trim.
+
+	if ( unlikely( trimThreshold != 0 ) ) {
+	    if ( uFetchAdd( freedSinceTrim, size ) + size >= trimThreshold ) {
+		freedSinceTrim = 0;
+		trim( heapExpand );
+	    } // if
+	} // if
+    } // uHeapManager::freed
+
+
+    inline void *uHeapManager::doMalloc( size_t size, FreeHeader *aligned ) {
 #ifdef __U_DEBUG_H__
-	uDebugPrt( "(uHeapManager &)%p.doMalloc( %zu )\n", this, size );
+	uDebugPrt( "(uHeapManager &)%p.doMalloc( %zu, %p )\n", this, size, aligned );
 #endif // __U_DEBUG_H__
 
 	Storage *block;
@@ -243,19 +1311,12 @@ namespace UPP {
 	// along with the block and is a multiple of the alignment size.
 
 	size_t tsize = size + sizeof(Storage::Header);
-	if ( tsize >= mmapStart ) {			// large size => mmap
-	    tsize = uCeiling( tsize, pageSize );	// must be multiple of page size
+	if ( aligned == NULL && tsize >= mmapStart ) {	// large size => mmap
+	    block = mmapBlock( tsize );			// round up tsize to mapped size
 #ifdef __U_STATISTICS__
 	    uFetchAdd( mmap_calls, 1 );
 	    uFetchAdd( mmap_storage, tsize );
 #endif // __U_STATISTICS__
-	    int mmapFlags = MAP_PRIVATE |
-#if defined( __freebsd__ )
-		MAP_ANON;
-#else
-		MAP_ANONYMOUS;
-#endif
-	    block = (Storage *)::mmap( 0, tsize, PROT_READ | PROT_WRITE, mmapFlags, mmapFd, 0 );
 	    if ( block == MAP_FAILED ) {
 		// Do not call strerror( errno ) as it may call malloc.
 		uAbort( "(uHeapManager &)0x%p.doMalloc() : internal error, mmap failure, size:%zu error:%d.", this, tsize, errno );
@@ -266,41 +1327,90 @@ namespace UPP {
 #endif // __U_DEBUG__
 	    block->header.kind.real.blockSize = tsize;	// storage size for munmap
 	} else {
-	    FreeHeader key;
-	    key.blockSize = tsize;			// fake element for search
-	    FreeHeader *freeElem =
+	    FreeHeader *freeElem = aligned;		// aligned size class chosen by memalign ?
+	    if ( likely( freeElem == NULL ) ) {
+		FreeHeader key;
+		key.blockSize = tsize;			// fake element for search
+		freeElem =
 #ifdef FASTLOOKUP
-		tsize < LookupSizes ? &freeLists[lookup[tsize]] :
+		    tsize < LookupSizes ? &freeLists[lookup[tsize]] :
 #endif // FASTLOOKUP
-		std::lower_bound( freeLists, freeLists + maxBucketsUsed, key ); // binary search
-	    assert( freeElem <= &freeLists[maxBucketsUsed] ); // subscripting error ?
+		    std::lower_bound( freeLists, freeLists + maxBucketsUsed, key ); // binary search
+		assert( freeElem <= &freeLists[maxBucketsUsed] ); // subscripting error ?
+	    } // if
 	    assert( tsize <= freeElem->blockSize );	// search failure ?
+#ifdef __U_STATISTICS__
+	    BucketStats &stats = bucketStats[freeElem - freeLists];
+	    size_t lower = lowerSize( freeElem - freeLists );
+	    uFetchAdd( stats.allocs, 1 );
+	    uFetchAdd( stats.requested, size );
+	    uFetchAdd( stats.histogram[tsize <= lower ? 0 : ( tsize - lower - 1 ) * HistogramBins / ( freeElem->blockSize - lower )], 1 );
+	    unsigned int live = uFetchAdd( stats.live, 1 ) + 1;
+	    if ( unlikely( live > stats.peak ) ) stats.peak = live; // racy, but only a statistic
+#endif // __U_STATISTICS__
 	    tsize = freeElem->blockSize;		// total space needed for request
 
 #ifdef __U_DEBUG_H__
 	    uDebugPrt( "(uHeapManager &)%p.doMalloc, size after lookup:%zu\n", this, tsize );
 #endif // __U_DEBUG_H__
-    
-	    // Spin until the lock is acquired for this particular size of block.
 
-	    freeElem->lock.acquire();
-	    if ( likely( freeElem->freeList != NULL ) ) {
-		block = freeElem->freeList;		// remove node from stack
-		freeElem->freeList = block->header.kind.real.next;
-		freeElem->lock.release();
-	    } else {
-		freeElem->lock.release();
+	    block = NULL;
+	    uHeapManager *arena = this;
+	    bool small = freeElem->blockSize <= CacheLimit;
+	    if ( likely( small ) || unlikely( numaArenas ) ) { // small size => processor cache, or node arena
+		THREAD_GETMEM( This )->disableInterrupts();
+		ProcessorCache *cache = processorCache();
+		if ( likely( cache != NULL ) ) {
+		    if ( unlikely( cache->arena != this ) ) { // allocate from the processor's node arena
+			arena = cache->arena;
+			freeElem = &arena->freeLists[freeElem - freeLists];
+		    } // if
+		    if ( likely( small ) ) {
+			ProcessorCache::Bucket &bucket = cache->buckets[freeElem - arena->freeLists];
+			if ( likely( bucket.freeList != NULL ) ) {
+#ifdef __U_STATISTICS__
+			    uFetchAdd( cache_alloc_hits, 1 );
+#endif // __U_STATISTICS__
+			} else if ( unlikely( ! arena->cacheRefill( freeElem, bucket ) ) ) {
+			    THREAD_GETMEM( This )->enableInterrupts();
+			    return NULL;
+			} // if
+			block = bucket.freeList;	// remove node from stack
+			bucket.freeList = block->header.kind.real.next;
+			bucket.count -= 1;
+		    } // if
+		} // if
+		THREAD_GETMEM( This )->enableInterrupts();
+	    } // if
+
+	    if ( block == NULL ) {
+		// Spin until the lock is acquired for this particular size of block.
+
+		freeElem->lock.acquire();
+		if ( likely( freeElem->freeList != NULL ) ) {
+		    block = freeElem->freeList;		// remove node from stack
+		    freeElem->freeList = block->header.kind.real.next;
+		    freeElem->lock.release();
+		    if ( unlikely( tsize >= 2 * pageSize ) ) *(uintptr_t *)block->data = 0; // clear trim mark
+		} else {
+		    freeElem->lock.release();
 
-		// Freelist for that size was empty, so carve it out of the heap if there's enough left, or get some more
-		// and then carve it off.
+		    // Freelist for that size was empty, so carve it out of the heap if there's enough left, or get some
+		    // more and then carve it off.
 
-		block = (Storage *)extend( tsize );	// mutual exclusion on call
-		if ( unlikely( block == NULL ) ) return NULL;
+		    block = (Storage *)( likely( aligned == NULL ) ? arena->extend( tsize ) : arena->extendAligned( freeElem ) ); // mutual exclusion on call
+		    if ( unlikely( block == NULL ) ) return NULL;
+		} // if
 	    } // if
 
 	    block->header.kind.real.home = freeElem;	// pointer back to free list of apropriate size
 	} // if
 
+#ifdef __U_STATISTICS__
+	allocated( tsize );
+#endif // __U_STATISTICS__
+	if ( unlikely( sampleRate != 0 ) ) sample( block, size ); // heap profile ?
+
 	void *area = &(block->data);			// adjust off header to user bytes
 
 #ifdef __U_DEBUG__
@@ -337,10 +1447,14 @@ namespace UPP {
 	FreeHeader *freeElem;
 	size_t size, alignment;				// not used (see realloc)
 
-	if ( headers( "free", addr, header, freeElem, size, alignment ) ) { // mmapped ?
+	bool mapped = headers( "free", addr, header, freeElem, size, alignment );
+	if ( unlikely( header->kind.real.blockSize & SampledBit ) ) unsample( header ); // sampled block ?
+
+	if ( mapped ) {
 #ifdef __U_STATISTICS__
 	    uFetchAdd( munmap_calls, 1 );
 	    uFetchAdd( munmap_storage, size );
+	    uFetchAdd( inUse, -(long long int)size );
 #endif // __U_STATISTICS__
 	    if ( munmap( header, size ) == -1 ) {
 #ifdef __U_DEBUG__
@@ -365,13 +1479,43 @@ namespace UPP {
 	    uDebugPrt( "(uHeapManager &)%p.doFree( %p ) header:%p freeElem:%p\n", this, addr, &header, &freeElem );
 #endif // __U_DEBUG_H__
 
-	    freeElem->lock.acquire();			// acquire spin lock
+	    bool cached = false;
+	    unsigned int flushed = 0;
+	    uHeapManager *arena = arenaOf( freeElem );	// home arena of the block
 #ifdef __U_STATISTICS__
-	    free_storage += size;
+	    uFetchAdd( free_storage, size );
+	    uFetchAdd( inUse, -(long long int)size );
+	    uFetchAdd( bucketStats[freeElem - arena->freeLists].live, -1 );
 #endif // __U_STATISTICS__
-	    header->kind.real.next = freeElem->freeList; // push on stack
-	    freeElem->freeList = (Storage *)header;
-	    freeElem->lock.release();			// release spin lock
+	    if ( likely( freeElem->blockSize <= CacheLimit ) ) { // small size => processor cache
+		THREAD_GETMEM( This )->disableInterrupts();
+		ProcessorCache *cache = processorCache();
+		if ( likely( cache != NULL && cache->arena == arena ) ) { // only cache blocks of the processor's arena
+		    ProcessorCache::Bucket &bucket = cache->buckets[freeElem - arena->freeLists];
+		    if ( unlikely( bucket.count >= CacheMax ) ) { // cache full ?
+			flushed = arena->cacheFlush( freeElem, bucket, CacheBatch );
+#ifdef __U_STATISTICS__
+		    } else {
+			uFetchAdd( cache_free_hits, 1 );
+#endif // __U_STATISTICS__
+		    } // if
+		    header->kind.real.next = bucket.freeList; // push on stack
+		    bucket.freeList = (Storage *)header;
+		    bucket.count += 1;
+		    cached = true;
+		} // if
+		THREAD_GETMEM( This )->enableInterrupts();
+	    } // if
+
+	    if ( ! cached ) {
+		freeElem->lock.acquire();		// acquire spin lock
+		header->kind.real.next = freeElem->freeList; // push on stack
+		freeElem->freeList = (Storage *)header;
+		freeElem->lock.release();		// release spin lock
+		arena->freed( size );
+	    } else if ( unlikely( flushed != 0 ) ) {
+		arena->freed( flushed * size );
+	    } // if
 
 #ifdef __U_DEBUG_H__
 	    uDebugPrt( "(uHeapManager &)%p.doFree( %p ) returning free block in list 0x%zx\n", this, addr, size );
@@ -420,15 +1564,29 @@ namespace UPP {
     } // uHeapManager::checkFree
 
 
+    void uHeapManager::initLists() {
+	for ( unsigned int i = 0; i < NoBucketSizes; i += 1 ) { // initialize the free lists
+	    freeLists[i].blockSize = bucketSizes[i];
+	} // for
+	for ( unsigned int a = 0; a < NoAlignments; a += 1 ) { // initialize the aligned size classes
+	    for ( unsigned int i = 0; i < AlignedMultiples; i += 1 ) {
+		freeLists[NoBucketSizes + a * AlignedMultiples + i].blockSize = alignments[a] * alignedMultiples[i];
+	    } // for
+	} // for
+    } // uHeapManager::initLists
+
+
     uHeapManager::uHeapManager() {
 #ifdef __U_DEBUG_H__
 	uDebugPrt( "(uHeapManager &)%p.uHeap()\n", this );
 #endif // __U_DEBUG_H__
 	pageSize = sysconf( _SC_PAGESIZE );
-    
-	for ( unsigned int i = 0; i < NoBucketSizes; i += 1 ) { // initialize the free lists
-	    freeLists[i].blockSize = bucketSizes[i];
-	} // for
+
+	const char *buckets = uDefaultHeapBuckets();
+	if ( buckets != NULL && loadBuckets( buckets ) ) {
+	    uAbort( "uHeapManager::uHeapManager : unreadable, invalid or too large heap bucket file \"%s\".", buckets );
+	} // if
+	initLists();
 
 #ifdef FASTLOOKUP
 	unsigned int idx = 0;
@@ -442,17 +1600,33 @@ namespace UPP {
 	    uAbort( "uHeapManager::uHeapManager : internal error, mmap start initialization failure." );
 	} // if
 	heapExpand = uDefaultHeapExpansion();
+	if ( setHugePages( uDefaultHeapHugePages() ) ) {
+	    uAbort( "uHeapManager::uHeapManager : invalid huge-page mode %u.", uDefaultHeapHugePages() );
+	} // if
 
 	char *end = (char *)sbrk( 0 );
 	sbrk( (char *)uCeiling( (long unsigned int)end, uAlign() ) - end ); // move start of heap to multiple of alignment
 	heapBegin = heapEnd = sbrk( 0 );		// get new start point
 
+	numaNodes = countNodes();			// node arenas are only used when enabled by mallopt( M_NUMA_ARENAS, 1 )
+
 #ifdef __U_DEBUG_H__
 	uDebugPrt( "(uHeapManager &)%p.uHeap() heapBegin:%p, heapEnd:%p\n", this, heapBegin, heapEnd );
 #endif // __U_DEBUG_H__
     } // uHeapManager::uHeapManager
 
 
+    uHeapManager::uHeapManager( unsigned int node, char *begin, char *limit ) {
+	// Node arena: the bucket sizes and other global values are already initialized.
+
+	initLists();
+	heapBegin = heapEnd = begin;
+	heapRemaining = 0;
+	heapLimit = limit;
+	this->node = node;
+    } // uHeapManager::uHeapManager
+
+
     uHeapManager::~uHeapManager() {
 #ifdef __U_STATISTICS__
 	if ( UPP::Statistics::prtHeapterm ) {
@@ -513,6 +1687,10 @@ namespace UPP {
 	return uHeapManager::heapManagerInstance != NULL;
     } // uHeapControl::initialized
 
+    unsigned int uHeapControl::trimInterval() {
+	return uHeapManager::trimInterval;
+    } // uHeapControl::trimInterval
+
     void uHeapControl::startup() {
 	// Just in case no previous malloc, initialization of heap.
 
@@ -520,6 +1698,11 @@ namespace UPP {
 	    uHeapManager::boot();
 	} // if
 
+	// Sampling starts after the kernel is booted because backtrace may allocate storage and use locks.
+	if ( uHeapManager::setSampleRate( uDefaultHeapSample() ) ) {
+	    uAbort( "uHeapControl::startup : heap-profile sampling rate %u is not supported.", uDefaultHeapSample() );
+	} // if
+
 	// Storage allocated before the start of uC++ is normally not freed until after uC++ completes (if at all). Hence,
 	// this storage is not considered when calculating unfreed storage when the heap's destructor is called in finishup.
 
@@ -536,6 +1719,35 @@ namespace UPP {
 	uHeapManager::heapManagerInstance->uHeapManager::~uHeapManager();
     } // uHeapControl::finishup
 
+    void uHeapControl::prepareProcessor( uProcessor *processor ) {
+	// The cache is created on the first allocation by a task on the processor.
+    } // uHeapControl::prepareProcessor
+
+    void uHeapControl::finishProcessor( uProcessor *processor ) {
+	// The processor has terminated so no task can access its cache.  Return the cached blocks to the free lists and
+	// keep the cache storage for the next processor.
+
+	uHeapManager::ProcessorCache *cache = (uHeapManager::ProcessorCache *)processor->heapData;
+      if ( cache == NULL ) return;
+	uHeapManager *heap = uHeapManager::heapManagerInstance, *arena = cache->arena;
+	if ( arena != NULL ) {
+	    for ( unsigned int i = 0; i < uHeapManager::NoBucketSizes + uHeapManager::NoAlignedSizes; i += 1 ) {
+		arena->cacheFlush( &arena->freeLists[i], cache->buckets[i], cache->buckets[i].count );
+	    } // for
+	} // if
+	processor->heapData = NULL;
+	heap->extlock.acquire();
+	cache->next = uHeapManager::spareCaches;
+	uHeapManager::spareCaches = cache;
+	heap->extlock.release();
+    } // uHeapControl::finishProcessor
+
+    void uHeapControl::affinityChanged() {
+	// A processor may now run on a different NUMA node, so every processor rebinds its node arena.
+
+	if ( uHeapManager::numaArenas ) uFetchAdd( uHeapManager::arenaGeneration, 1 );
+    } // uHeapControl::affinityChanged
+
     void uHeapControl::prepareTask( uBaseTask *task ) {
     } // uHeapControl::prepareTask
 
@@ -543,6 +1755,8 @@ namespace UPP {
     } // uHeapControl::startTask
 
     void uHeapControl::finishTask() {
+	uBaseTask &task = uThisTask();
+	if ( task.heapData != NULL ) uRegion::finishTask( task ); // release regions bound to the task
     } // uHeapControl::finishTask
 } // UPP
 
@@ -566,7 +1780,7 @@ extern "C" {
 #ifdef __U_PROFILER__
 	if ( uThisTask().profileActive && uProfiler::uProfiler_registerMemoryAllocate ) {
 	    UPP::uHeapManager::Storage::Header *header = (UPP::uHeapManager::Storage::Header *)( (char *)area - sizeof(UPP::uHeapManager::Storage::Header) );
-	    PROFILEMALLOCENTRY( header ) = (*uProfiler::uProfiler_registerMemoryAllocate)( uProfiler::profilerInstance, area, size, header->kind.real.blockSize & -3 );
+	    PROFILEMALLOCENTRY( header ) = (*uProfiler::uProfiler_registerMemoryAllocate)( uProfiler::profilerInstance, area, size, header->kind.real.blockSize & ~(size_t)UPP::uHeapManager::HeaderFlags );
 	} // if
 #endif // __U_PROFILER__
 #ifdef __U_DEBUG_H__
@@ -641,12 +1855,16 @@ extern "C" {
 	UPP::uHeapManager::Storage::Header *header;
 	UPP::uHeapManager::FreeHeader *freeElem;
 	size_t asize, alignment = 0;
-	UPP::uHeapManager::heapManagerInstance->headers( "realloc", addr, header, freeElem, asize, alignment );
+	bool mapped = UPP::uHeapManager::heapManagerInstance->headers( "realloc", addr, header, freeElem, asize, alignment );
+	if ( ! mapped && alignment == 0 ) alignment = UPP::uHeapManager::classAlignment( freeElem ); // aligned size class ?
 
 	size_t usize = asize - ( (char *)addr - (char *)header ); // compute the amount of user storage in the block
       if ( usize >= size ) {				// already sufficient storage
 	    // This case does not result in a new profiler entry because the previous one still exists and it must match with
 	    // the free for this memory.  Hence, this realloc does not appear in the profiler output.
+#ifdef __U_STATISTICS__
+	    uFetchAdd( UPP::uHeapManager::realloc_inplace, 1 );
+#endif // __U_STATISTICS__
 	    return addr;
 	} // if
 
@@ -654,6 +1872,42 @@ extern "C" {
 	uFetchAdd( UPP::uHeapManager::realloc_storage, size );
 #endif // __U_STATISTICS__
 
+#if defined( __linux__ )
+	// An mmapped block is grown by remapping its pages rather than copying them. The offset of the user storage in the
+	// mapping is unchanged, so alignments up to the page size are preserved. As above, there is no new profiler entry.
+	if ( mapped && alignment <= UPP::uHeapManager::pageSize ) {
+	    size_t offset = (char *)addr - (char *)header;
+	    size_t tsize = offset + size;
+	    tsize = uCeiling( tsize, UPP::uHeapManager::hugePages != UPP::uHeapManager::HugeNone && tsize >= UPP::uHeapManager::HugePageSize ?
+			      (size_t)UPP::uHeapManager::HugePageSize : UPP::uHeapManager::pageSize );
+	    if ( unlikely( header->kind.real.blockSize & UPP::uHeapManager::SampledBit ) ) { // sample is keyed by the header address
+		UPP::uHeapManager::unsample( header );
+	    } // if
+	    void *mem = ::mremap( header, asize, tsize, MREMAP_MAYMOVE );
+	    if ( mem != MAP_FAILED ) {
+		header = (UPP::uHeapManager::Storage::Header *)mem;
+		bool zeroFill = ( header->kind.real.blockSize & 2 ) != 0;
+		header->kind.real.blockSize = tsize | ( zeroFill ? 2 : 0 ); // new pages are zero filled
+#ifdef __U_STATISTICS__
+		uFetchAdd( UPP::uHeapManager::realloc_mremap, 1 );
+		uFetchAdd( UPP::uHeapManager::mmap_storage, tsize - asize );
+		UPP::uHeapManager::allocated( tsize - asize );
+#endif // __U_STATISTICS__
+#ifdef __U_DEBUG__
+		if ( ! zeroFill ) {
+		    // Set new memory to garbage so subsequent uninitialized usages might fail.
+		    memset( (char *)mem + asize, '\377', tsize - asize );
+		} // if
+		uFetchAdd( UPP::uHeapManager::allocfree, tsize - asize );
+#endif // __U_DEBUG__
+#ifdef __U_DEBUG_H__
+		uDebugPrt( "%p = realloc( %p, %zu ) mremap\n", (char *)mem + offset, addr, size );
+#endif // __U_DEBUG_H__
+		return (char *)mem + offset;
+	    } // if
+	} // if
+#endif // __linux__
+
 	void *area;
 	if ( unlikely( alignment != 0 ) ) {		// previous request memalign?
 	    area = memalign( alignment, size );		// create new area
@@ -696,6 +1950,27 @@ extern "C" {
 	// if alignment <= default alignment, do normal malloc as two headers are unnecessary
       if ( unlikely( alignment <= uAlign() ) ) return malloc( size );
 
+	// Common alignments have size classes whose user storage is aligned, so only one header is necessary.
+	UPP::uHeapManager::FreeHeader *aligned = UPP::uHeapManager::heapManagerInstance->alignedClass( alignment, size );
+	if ( likely( aligned != NULL ) ) {
+#ifdef __U_STATISTICS__
+	    uFetchAdd( UPP::uHeapManager::memalign_native, 1 );
+#endif // __U_STATISTICS__
+	    void *area = UPP::uHeapManager::heapManagerInstance->doMalloc( size, aligned );
+	    if ( unlikely( area == NULL ) ) errno = ENOMEM;
+	    assert( ((uintptr_t)area & (alignment - 1)) == 0 ); // aligned ?
+#ifdef __U_PROFILER__
+	    if ( uThisTask().profileActive && uProfiler::uProfiler_registerMemoryAllocate ) {
+		UPP::uHeapManager::Storage::Header *header = (UPP::uHeapManager::Storage::Header *)( (char *)area - sizeof(UPP::uHeapManager::Storage::Header) );
+		PROFILEMALLOCENTRY( header ) = (*uProfiler::uProfiler_registerMemoryAllocate)( uProfiler::profilerInstance, area, size, ((UPP::uHeapManager::FreeHeader *)((size_t)header->kind.real.home & ~(size_t)UPP::uHeapManager::HeaderFlags))->blockSize );
+	    } // if
+#endif // __U_PROFILER__
+#ifdef __U_DEBUG_H__
+	    uDebugPrt( "%p = memalign( %zu, %zu ) aligned size class\n", area, alignment, size );
+#endif // __U_DEBUG_H__
+	    return area;
+	} // if
+
 	// Allocate enough storage to guarantee an address on the alignment boundary, and sufficient space before it for
 	// administrative storage. NOTE, WHILE THERE ARE 2 HEADERS, THE FIRST ONE IS IMPLICITLY CREATED BY DOMALLOC.
 	//      .-------------v-----------------v----------------v----------,
@@ -722,7 +1997,7 @@ extern "C" {
 
 #ifdef __U_PROFILER__
 	if ( uThisTask().profileActive && uProfiler::uProfiler_registerMemoryAllocate ) {
-	    PROFILEMALLOCENTRY( fakeHeader ) = (*uProfiler::uProfiler_registerMemoryAllocate)( uProfiler::profilerInstance, area, size, realHeader->kind.real.home->blockSize & -3 );
+	    PROFILEMALLOCENTRY( fakeHeader ) = (*uProfiler::uProfiler_registerMemoryAllocate)( uProfiler::profilerInstance, area, size, ((UPP::uHeapManager::FreeHeader *)((size_t)realHeader->kind.real.home & ~(size_t)UPP::uHeapManager::HeaderFlags))->blockSize );
 	} // if
 #endif // __U_PROFILER__
 
@@ -741,6 +2016,11 @@ extern "C" {
     } // posix_memalign
 
 
+    void *aligned_alloc( size_t alignment, size_t size ) __THROW {
+	return memalign( alignment, size );
+    } // aligned_alloc
+
+
     void *valloc( size_t size ) __THROW {
 	return memalign( UPP::uHeapManager::pageSize, size );
     } // valloc
@@ -776,15 +2056,53 @@ extern "C" {
     } // free
 
 
+    // The block header is still needed to find the home free list and arena, and to recognize mmapped storage, which
+    // realloc may shrink in place, so the size is only checked.
+
+    void free_sized( void *addr, size_t size ) __THROW {
+#ifdef __U_DEBUG__
+	if ( addr != NULL ) {
+	    UPP::uHeapManager::Storage::Header *header;
+	    UPP::uHeapManager::FreeHeader *freeElem;
+	    size_t asize, alignment = 0;
+	    UPP::uHeapManager::heapManagerInstance->headers( "free_sized", addr, header, freeElem, asize, alignment );
+	    if ( size > asize - ( (char *)addr - (char *)header ) ) {
+		uAbort( "Attempt to free_sized storage %p with size %zu larger than its allocation.\n"
+			"Possible cause is passing the wrong size or pointer.",
+			addr, size );
+	    } // if
+	} // if
+#endif // __U_DEBUG__
+	free( addr );
+    } // free_sized
+
+
+    void free_aligned_sized( void *addr, size_t alignment, size_t size ) __THROW {
+#ifdef __U_DEBUG__
+	if ( addr != NULL && malloc_alignment( addr ) < alignment ) {
+	    uAbort( "Attempt to free_aligned_sized storage %p with alignment %zu larger than its allocation.\n"
+		    "Possible cause is passing the wrong alignment or pointer.",
+		    addr, alignment );
+	} // if
+#endif // __U_DEBUG__
+	free_sized( addr, size );
+    } // free_aligned_sized
+
+
     size_t malloc_alignment( void *addr ) __THROW {
       if ( unlikely( addr == NULL ) ) return uAlign(); // minimum alignment
 	UPP::uHeapManager::Storage::Header *header = (UPP::uHeapManager::Storage::Header *)( (char *)addr - sizeof(UPP::uHeapManager::Storage::Header) );
 	if ( (header->kind.fake.alignment & 1) == 1 ) {	// fake header ?
 	    return header->kind.fake.alignment & -2;	// remove flag from value
 	} else {
-	    return uAlign();				// minimum alignment
+	    UPP::uHeapManager::FreeHeader *freeElem;
+	    size_t size, alignment = 0;
+	    if ( ! UPP::uHeapManager::heapManagerInstance->headers( "malloc_alignment", addr, header, freeElem, size, alignment ) ) {
+		alignment = UPP::uHeapManager::classAlignment( freeElem ); // aligned size class ?
+	    } // if
+	    return alignment != 0 ? alignment : uAlign(); // minimum alignment
 	} // if
-    } // malloc_usable_size
+    } // malloc_alignment
 
 
 //     bool malloc_zero_fill( void *addr ) __THROW {
@@ -838,6 +2156,34 @@ extern "C" {
     } // malloc_stats_fd
 
 
+    // Dump the heap profile (see M_HEAP_SAMPLE); while sampling, SIGUSR2 requests a dump at the next counted allocation. The
+    // profile lock is held while writing, so sampled allocations and frees wait for the dump.
+
+    void malloc_profile() __THROW {
+      if ( UPP::uHeapManager::profile == NULL ) return; // sampling never started
+	UPP::uHeapManager::profile->lock.acquire();
+	UPP::uHeapManager::profileDump( UPP::uHeapManager::profileFd );
+	UPP::uHeapManager::profile->lock.release();
+    } // malloc_profile
+
+
+    int malloc_profile_fd( int fd ) __THROW {
+	int temp = UPP::uHeapManager::profileFd;
+	UPP::uHeapManager::profileFd = fd;
+	return temp;
+    } // malloc_profile_fd
+
+
+    int malloc_trim( size_t pad ) __THROW {
+	if ( unlikely( UPP::uHeapManager::heapManagerInstance == NULL ) ) return 0;
+	size_t released = UPP::uHeapManager::heapManagerInstance->trim( pad );
+	for ( unsigned int i = 0; i < UPP::uHeapManager::numaNodes; i += 1 ) {
+	    if ( UPP::uHeapManager::arenas[i] != NULL ) released += UPP::uHeapManager::arenas[i]->trim( pad );
+	} // for
+	return released != 0;
+    } // malloc_trim
+
+
     int mallopt( int option, int value ) __THROW {
 	switch( option ) {
 	  case M_TOP_PAD:
@@ -846,6 +2192,27 @@ extern "C" {
 	  case M_MMAP_THRESHOLD:
 	    if ( UPP::uHeapManager::heapManagerInstance->setMmapStart( value ) ) return 1;
 	    break;
+	  case M_TRIM_THRESHOLD:			// 0 => no automatic trim
+	    if ( value < 0 ) return 1;
+	    UPP::uHeapManager::trimThreshold = value;
+	    break;
+	  case M_TRIM_INTERVAL:				// 0 => no background trim
+	    if ( value < 0 ) return 1;
+	    UPP::uHeapManager::trimInterval = value;
+	    // The system task waits with the previous period, or without a timeout, so wake it to use the new period.
+	    if ( uKernelModule::systemTask != NULL && &uThisTask() != (uBaseTask *)uKernelModule::systemTask ) {
+		uKernelModule::systemTask->trimIntervalChanged();
+	    } // if
+	    break;
+	  case M_HUGE_PAGES:
+	    if ( UPP::uHeapManager::setHugePages( value ) ) return 1;
+	    break;
+	  case M_NUMA_ARENAS:
+	    if ( UPP::uHeapManager::setNumaArenas( value != 0 ) ) return 1;
+	    break;
+	  case M_HEAP_SAMPLE:				// 0 => no sampling
+	    if ( value < 0 || UPP::uHeapManager::setSampleRate( value ) ) return 1;
+	    break;
 	  default:
 	    return 1;
 	} // switch
@@ -854,6 +2221,52 @@ extern "C" {
 } // extern "C"
 
 
+// Replace the sized and aligned forms of the global allocation operators so they use the aligned size classes and the
+// sized deallocation checks.
+
+#if defined( __cpp_sized_deallocation )
+void operator delete( void *addr, size_t size ) noexcept {
+    free_sized( addr, size );
+} // operator delete
+
+void operator delete[]( void *addr, size_t size ) noexcept {
+    free_sized( addr, size );
+} // operator delete[]
+#endif // __cpp_sized_deallocation
+
+#if defined( __cpp_aligned_new )
+void *operator new( size_t size, std::align_val_t alignment ) {
+    for ( ;; ) {
+	void *addr = memalign( (size_t)alignment, size );
+      if ( addr != NULL ) return addr;
+	std::new_handler handler = std::get_new_handler();
+      if ( handler == NULL ) throw std::bad_alloc();
+	handler();
+    } // for
+} // operator new
+
+void *operator new[]( size_t size, std::align_val_t alignment ) {
+    return operator new( size, alignment );
+} // operator new[]
+
+void operator delete( void *addr, std::align_val_t ) noexcept {
+    free( addr );
+} // operator delete
+
+void operator delete[]( void *addr, std::align_val_t ) noexcept {
+    free( addr );
+} // operator delete[]
+
+void operator delete( void *addr, size_t size, std::align_val_t alignment ) noexcept {
+    free_aligned_sized( addr, (size_t)alignment, size );
+} // operator delete
+
+void operator delete[]( void *addr, size_t size, std::align_val_t alignment ) noexcept {
+    free_aligned_sized( addr, (size_t)alignment, size );
+} // operator delete[]
+#endif // __cpp_aligned_new
+
+
 // Local Variables: //
 // compile-command: "make install" //
 // End: //
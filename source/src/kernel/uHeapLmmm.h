@@ -32,6 +32,7 @@
 #define FASTLOOKUP
 
 class MMInfoEntry;					// for profiler
+class uRegion;						// forward declaration
 
 #if defined( __GNUC__ ) && (__GNUC__ > 4 || __GNUC__ == 4 && __GNUC_MINOR__ > 2 || __GNUC__ == 4 && __GNUC_MINOR__ == 2 && __GNUC_PATCHLEVEL__ >= 1)
 #define uMallReturnType size_t
@@ -48,21 +49,27 @@ extern "C" void *malloc( size_t size ) __THROW;
 extern "C" void *calloc( size_t noOfElems, size_t elemSize ) __THROW;
 extern "C" void *realloc( void *addr, size_t size ) __THROW;
 extern "C" void *memalign( size_t alignment, size_t size ) __THROW;
+extern "C" void *aligned_alloc( size_t alignment, size_t size ) __THROW;
 extern "C" void *valloc( size_t size ) __THROW;
 extern "C" void free( void *addr ) __THROW;
+extern "C" void free_sized( void *addr, size_t size ) __THROW;
+extern "C" void free_aligned_sized( void *addr, size_t alignment, size_t size ) __THROW;
 extern "C" uMallReturnType malloc_alignment( void *addr ) __THROW;
 extern "C" bool malloc_zero_fill( void *addr ) __THROW;
 extern "C" uMallReturnType malloc_usable_size( void *addr ) __THROW;
 extern "C" void malloc_stats() __THROW;
 extern "C" int malloc_stats_fd( int fd ) __THROW;
+extern "C" void malloc_profile() __THROW;
+extern "C" int malloc_profile_fd( int fd ) __THROW;
 extern "C" int mallopt( int param_number, int value ) __THROW;
+extern "C" int malloc_trim( size_t pad ) __THROW;
 
 
 namespace UPP {
     class uHeapManager {
 	friend class uKernelBoot;			// access: uHeap
 	friend class UPP::uMachContext;			// access: pageSize
-	friend class UPP::uSigHandlerModule;		// access: print
+	friend class UPP::uSigHandlerModule;		// access: print, profileRequested
 	friend void *::malloc( size_t size ) __THROW;	// access: boot
 	friend void *::calloc( size_t noOfElems, size_t elemSize ) __THROW;
 	friend void *::cmemalign( size_t alignment, size_t noOfElems, size_t elemSize ) __THROW; // access: Storage
@@ -70,13 +77,19 @@ namespace UPP {
 	friend void *::memalign( size_t alignment, size_t size ) __THROW; // access: boot
 	friend void *::valloc( size_t size ) __THROW;	// access: pageSize
 	friend void ::free( void *addr ) __THROW;	// access: doFree
-	friend int ::mallopt( int param_number, int value ) __THROW; // access: heapManagerInstance, setHeapExpand, setMmapStart
-	friend uMallReturnType ::malloc_alignment( void *addr ) __THROW; // access: Header, FreeHeader
+	friend int ::mallopt( int param_number, int value ) __THROW; // access: heapManagerInstance, setHeapExpand, setMmapStart, setHugePages, setNumaArenas, setSampleRate, trimThreshold, trimInterval
+	friend int ::malloc_trim( size_t pad ) __THROW;	// access: heapManagerInstance, arenas, trim
+	friend void ::free_sized( void *addr, size_t size ) __THROW; // access: heapManagerInstance, headers
+	friend void ::free_aligned_sized( void *addr, size_t alignment, size_t size ) __THROW; // access: heapManagerInstance, headers
+	friend uMallReturnType ::malloc_alignment( void *addr ) __THROW; // access: Header, FreeHeader, classAlignment
 	friend bool ::malloc_zero_fill( void *addr ) __THROW; // access: Storage
 	friend uMallReturnType ::malloc_usable_size( void *addr ) __THROW; // access: Header, FreeHeader
 	friend void ::malloc_stats() __THROW;
 	friend int ::malloc_stats_fd( int fd ) __THROW;
-	friend class uHeapControl;			// access: heapManagerInstance, boot
+	friend void ::malloc_profile() __THROW;		// access: profile, profileFd, profileDump
+	friend int ::malloc_profile_fd( int fd ) __THROW; // access: profileFd
+	friend class uHeapControl;			// access: heapManagerInstance, boot, cacheFlush, ProcessorCache, numaArenas, arenaGeneration, sampleRate, setSampleRate
+	friend class ::uRegion;				// access: heapManagerInstance, RegionChunk, regionChunk, regionRelease
 #ifdef __U_STATISTICS__
 	friend void UPP::Statistics::print();
 #endif // __U_STATISTICS__
@@ -127,18 +140,120 @@ namespace UPP {
 #ifdef FASTLOOKUP
 	       LookupSizes = 65536,			// number of fast lookup sizs
 #endif // FASTLOOKUP
+	       CacheLimit = 1024,			// largest block size with a per-processor cache
+	       CacheMax = 64,				// maximum free blocks per bucket in a processor cache
+	       CacheBatch = 32,				// free blocks moved between a processor cache and a free list
+	       HugePageSize = 2 * 1024 * 1024,		// alignment and size granularity when huge pages are requested
+	       MaxNumaNodes = 8,			// maximum NUMA nodes with their own arena
+	       MaxNumaCpus = 1024,			// CPUs mapped to their NUMA node
+	       NoNumaNode = 0xff,			// CPU not mapped to a node
+	       RegionChunk = 64 * 1024,			// storage obtained by a uRegion at a time
+	       RegionSpares = 16,			// spare region chunks kept for regions, others become free blocks
+	       NoAlignments = 3,			// alignments with native size classes
+	       AlignedMultiples = 8,			// size classes per alignment
+	       NoAlignedSizes = NoAlignments * AlignedMultiples,
+	       SampleDepth = 32,			// maximum frames in a sampled call stack
+	       SampleSites = 4096,			// call sites in the heap profile
+	       SampleBlocks = 65536,			// sampled blocks live at one time
+	       HistogramBins = 8,			// request-size bins per bucket
 	};
+	enum HugePages { HugeNone, HugeTransparent, HugeTLB }; // huge-page modes, see M_HUGE_PAGES
+	enum { ZeroFillBit = 2,				// header flag: zero filled block (calloc/cmemalign)
+	       SampledBit = __U_WORDSIZE__ == 64 ? 4 : 0, // header flag: sampled block, needs 8-byte aligned free lists
+	       HeaderFlags = ZeroFillBit | SampledBit,
+	};
+
+	// Small free blocks are cached per processor so most allocations and frees do not acquire a free-list lock. A
+	// cache is only accessed with interrupts disabled, so a task cannot migrate and another task cannot use the cache
+	// during an access. A cache is bound to the arena its processor allocates from and only holds blocks of that
+	// arena; it is rebound when the arena generation changes. Every size class of at most CacheLimit bytes is cached,
+	// including loaded bucket sizes and aligned size classes, so the cached classes are found by block size.
+
+	struct ProcessorCache {
+	    struct Bucket {
+		Storage *freeList;			// free blocks of this size
+		unsigned int count;			// number of blocks on list
+	    } buckets[NoBucketSizes + NoAlignedSizes];	// indexed as the free lists
+	    uHeapManager *arena;			// arena of the cached blocks
+	    unsigned int generation;			// arena generation when bound
+#ifdef __U_STATISTICS__
+	    ProcessorCache *nextCache;			// all caches, for statistics
+#endif // __U_STATISTICS__
+	    size_t sampleCountdown;			// bytes allocated before the next sample
+	    unsigned int sampleSeed;			// random state for the sample intervals, 0 => not started
+	    bool sampling;				// recording a sample, so allocations by backtrace are not sampled
+	    ProcessorCache *next;			// spare caches from deleted processors
+	}; // ProcessorCache
+
+	// Heap profile. On average, one allocation is sampled every sampleRate bytes allocated, using a countdown in each
+	// processor cache. The call stack of a sampled allocation is recorded once per call site with the counts of its
+	// sampled and live blocks. A sampled block is marked in its header, so only the free of a sampled block looks up
+	// its sample to subtract it from the live counts. The profile is mmapped when sampling starts, so it is zero
+	// filled and the lock is released.
+
+	struct Profile {
+	    struct Site {
+		Site *next;				// sites with the same hash
+		size_t hash;				// hash of the call stack
+		unsigned int depth;			// frames in the call stack
+		void *stack[SampleDepth];		// return addresses, innermost first
+		unsigned long long int allocCount, allocBytes; // sampled blocks
+		unsigned long long int liveCount, liveBytes; // sampled blocks not freed
+	    }; // Site
+
+	    struct Sample {
+		Sample *next;				// samples with the same hash, or free samples
+		Storage::Header *header;		// header of the sampled block
+		Site *site;				// call site of the allocation
+		size_t size;				// requested size
+	    }; // Sample
+
+	    uSpinLock lock;				// must be first field for alignment
+	    unsigned int usedSites, usedSamples;	// entries taken from the arrays
+	    unsigned long long int dropped;		// samples not recorded because a table is full
+	    size_t rate;				// sampling rate of the recorded samples
+	    Sample *freeSamples;			// samples of freed blocks for reuse
+	    Site *siteHash[SampleSites];
+	    Sample *sampleHash[SampleBlocks];
+	    Site sites[SampleSites];
+	    Sample samples[SampleBlocks];
+	}; // Profile
 
 	static uHeapManager *heapManagerInstance;	// pointer to heap manager object
 	static size_t pageSize;				// architecture pagesize
 	static size_t heapExpand;			// sbrk advance
 	static size_t mmapStart;			// cross over point for mmap
 	static unsigned int maxBucketsUsed;		// maximum number of buckets in use
+	static bool customBuckets;			// bucket sizes loaded from a file
 	static unsigned int bucketSizes[NoBucketSizes];	// different bucket sizes
+	static unsigned int alignments[NoAlignments];	// alignments of the aligned size classes
+	static unsigned char alignedMultiples[AlignedMultiples]; // aligned size classes as multiples of the alignment
 #ifdef FASTLOOKUP
 	static unsigned char lookup[LookupSizes];	// O(1) lookup for small sizes
 #endif // FASTLOOKUP
 	static int mmapFd;				// fake or actual fd for anonymous file
+	static ProcessorCache *spareCaches;		// caches of deleted processors, protected by extlock
+#ifdef __U_STATISTICS__
+	static ProcessorCache *allCaches;		// caches ever created, protected by extlock
+#endif // __U_STATISTICS__
+	static void *spareChunks;			// chunks released by regions, protected by extlock
+	static unsigned int spareChunkCount;		// chunks on spareChunks, protected by extlock
+	static size_t trimThreshold;			// freed storage that triggers a trim, 0 => no automatic trim
+	static unsigned int trimInterval;		// background trim period (milliseconds), 0 => none
+	static volatile size_t freedSinceTrim;		// storage returned to free lists since last trim
+	static unsigned int hugePages;			// HugePages mode for heap extension and large mmaps
+	static unsigned int numaNodes;			// NUMA nodes on the machine, at most MaxNumaNodes
+	static bool numaArenas;				// processors allocate from the arena of their NUMA node
+	static volatile unsigned int arenaGeneration;	// changes when processors must rebind their arena
+	static char *numaBase;				// address space reserved for the node arenas
+	static size_t numaReserve;			// address space per node arena
+	static size_t numaSpan;				// address space of all node arenas, 0 => not reserved
+	static uHeapManager *arenas[MaxNumaNodes];	// node arenas, created on first use, protected by extlock
+	static unsigned char cpuNodes[MaxNumaCpus];	// NUMA node of each CPU, NoNumaNode => unknown
+	static size_t sampleRate;			// mean bytes allocated between samples, 0 => no sampling
+	static Profile *profile;			// heap profile, created when sampling starts
+	static volatile bool profileRequested;		// dump the profile at the next sampled allocation (signal)
+	static int profileFd;				// file descriptor for profile dumps
 #ifdef __U_DEBUG__
 	static unsigned long int allocfree;		// running total of allocations minus frees
 #endif // __U_DEBUG__
@@ -159,10 +274,35 @@ namespace UPP {
 	static unsigned int calloc_calls;
 	static unsigned long long int memalign_storage;
 	static unsigned int memalign_calls;
+	static unsigned int memalign_native;		// memalign calls served by an aligned size class
 	static unsigned long long int cmemalign_storage;
 	static unsigned int cmemalign_calls;
 	static unsigned long long int realloc_storage;
 	static unsigned int realloc_calls;
+	static unsigned int realloc_inplace, realloc_mremap;
+	static unsigned int cache_alloc_hits, cache_alloc_refills;
+	static unsigned int cache_free_hits, cache_free_flushes;
+	static unsigned int trim_calls;
+	static unsigned long long int trim_madvise_storage;
+	static unsigned long long int trim_sbrk_storage;
+	static unsigned long long int huge_advise_storage; // storage advised MADV_HUGEPAGE
+	static unsigned long long int huge_tlb_storage;	// storage mapped MAP_HUGETLB
+	static unsigned int numa_calls;			// node arena extensions
+	static unsigned int numa_fallbacks;		// node arena extensions from the main heap
+	static unsigned int region_chunks, region_reuses, region_frees; // region chunks extended, reused and freed
+	static unsigned long long int numa_storage;
+
+	// Bucket statistics, indexed like the free lists of an arena, show how well the bucket sizes fit the requests.
+	struct BucketStats {
+	    unsigned int allocs;			// allocations from the bucket
+	    unsigned int live, peak;			// blocks allocated and not freed, maximum live
+	    unsigned long long int requested;		// bytes requested by the allocations
+	    unsigned int histogram[HistogramBins];	// allocations by request size, in equal parts of the bucket's size range
+	}; // BucketStats
+	static BucketStats bucketStats[NoBucketSizes + NoAlignedSizes];
+	static unsigned long long int inUse, peakInUse;	// storage in allocated blocks, including mmapped
+	static size_t lowerSize( unsigned int bucket );
+	static void allocated( size_t tsize );
 	static int statfd;
 	static void print();
 #endif // __U_STATISTICS__
@@ -170,25 +310,54 @@ namespace UPP {
 	// The next variables are statically allocated => zero filled.
 
 	// must be first fields for alignment
-	FreeHeader freeLists[NoBucketSizes];		// buckets for different allocation sizes
+	FreeHeader freeLists[NoBucketSizes + NoAlignedSizes]; // buckets for different allocation sizes, then aligned size classes
 	uSpinLock extlock;				// protects allocation-buffer extension
 
 	void *heapBegin;				// start of heap
 	void *heapEnd;					// logical end of heap
 	size_t heapRemaining;				// amount of storage not allocated in the current chunk
+	char *heapLimit;				// end of reserved address space for a node arena, NULL => sbrk heap
+	unsigned int node;				// NUMA node of a node arena
 
 	static void boot();
 	static void noMemory();				// called by "builtin_new" when malloc returns 0
 	static void checkAlign( size_t alignment );
 	static bool setHeapExpand( size_t value );
 	static bool setMmapStart( size_t value );
+	static bool setHugePages( unsigned int value );
+	static bool setNumaArenas( bool value );
+	static bool setSampleRate( size_t value );
+	static bool loadBuckets( const char *file );
+	static unsigned int countNodes();
+	static int currentNode();
+	static uHeapManager *nodeArena( unsigned int node );
+	static uHeapManager *arenaOf( FreeHeader *freeElem );
+	static bool inArena( void *addr );
 
 	bool headers( const char *name, void *addr, Storage::Header *&header, FreeHeader *&freeElem, size_t &size, size_t &alignment );
 	void *extend( size_t size );
-	void *doMalloc( size_t size );
+	void *extendAligned( FreeHeader *freeElem );
+	FreeHeader *alignedClass( size_t alignment, size_t size );
+	static size_t classAlignment( FreeHeader *freeElem );
+	void initLists();
+	static void bindArena( ProcessorCache *cache );
+	void *regionChunk();
+	void regionRelease( void *first, void *last );
+	Storage *mmapBlock( size_t &tsize );
+	ProcessorCache *processorCache();
+	bool cacheRefill( FreeHeader *freeElem, ProcessorCache::Bucket &bucket );
+	unsigned int cacheFlush( FreeHeader *freeElem, ProcessorCache::Bucket &bucket, unsigned int n );
+	static Storage *sortDescending( Storage *list ); // by address, for trim
+	size_t trim( size_t pad );
+	void freed( size_t size );
+	void sample( Storage *block, size_t size );
+	static void unsample( Storage::Header *header );
+	static void profileDump( int fd );
+	void *doMalloc( size_t size, FreeHeader *aligned = NULL );
 	void doFree( void *addr );
 	size_t checkFree( bool prt = false );
 	uHeapManager();
+	uHeapManager( unsigned int node, char *begin, char *limit );
 	~uHeapManager();
 
 	void *operator new( size_t, void *storage );
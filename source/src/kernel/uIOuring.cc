@@ -0,0 +1,271 @@
+//                              -*- Mode: C++ -*-
+//
+// uC++ Version 6.1.0, Copyright (C) agent 2026
+//
+// uIOuring.cc -- asynchronous disk I/O through an io_uring per cluster
+//
+// Author           : agent
+// Created On       : Sun Oct 18 05:39:46 2026
+// Last Modified By : agent
+// Last Modified On : Sun Oct 18 06:36:17 2026
+// Update Count     : 3
+//
+// This  library is free  software; you  can redistribute  it and/or  modify it
+// under the terms of the GNU Lesser General Public License as published by the
+// Free Software  Foundation; either  version 2.1 of  the License, or  (at your
+// option) any later version.
+//
+// This library is distributed in the  hope that it will be useful, but WITHOUT
+// ANY  WARRANTY;  without even  the  implied  warranty  of MERCHANTABILITY  or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+// for more details.
+//
+// You should  have received a  copy of the  GNU Lesser General  Public License
+// along  with this library.
+//
+
+
+#define __U_KERNEL__
+
+
+#include <uC++.h>
+//#include <uDebug.h>
+
+#if defined( __U_IO_URING__ )
+
+#include <cerrno>
+#include <cstring>					// memset, strerror
+#include <unistd.h>					// syscall, close
+#include <sys/syscall.h>				// __NR_io_uring_*
+#include <sys/mman.h>					// mmap, munmap
+#include <sys/eventfd.h>				// eventfd, eventfd_read
+#include <linux/io_uring.h>
+
+
+namespace UPP {
+    // A task waiting for an operation blocks on the semaphore in its request, which is on the task's stack and referred
+    // to by the completion entry. The semaphore is V'ed by whichever processor reaps the completion.
+
+    struct uIOuringRequest {
+	uSemaphore done;
+	int result;
+
+	uIOuringRequest() : done( 0 ) {}
+    }; // uIOuringRequest
+
+
+    uIOuring::uIOuring() : ringFd( -1 ), eventFd( -1 ), slots( Entries ), queued( 0 ), cycles( 0 ) {
+	io_uring_params params;
+	memset( &params, 0, sizeof( params ) );
+	int fd = ::syscall( __NR_io_uring_setup, Entries, &params );
+      if ( fd == -1 ) return;				// no io_uring (old kernel or disabled) => blocking system calls
+
+	// Offset -1 for reads and writes (use and advance the file position) requires IORING_FEAT_RW_CUR_POS, otherwise
+	// the file position is not shared with the blocking system calls on the same descriptor.
+	if ( ! ( params.features & IORING_FEAT_RW_CUR_POS ) ) {
+	    ::close( fd );
+	    return;
+	} // if
+
+	sq.ringSize = params.sq_off.array + params.sq_entries * sizeof( unsigned int );
+	cq.ringSize = params.cq_off.cqes + params.cq_entries * sizeof( io_uring_cqe );
+	if ( params.features & IORING_FEAT_SINGLE_MMAP ) { // both rings in one mapping ?
+	    if ( cq.ringSize > sq.ringSize ) sq.ringSize = cq.ringSize;
+	    cq.ringSize = sq.ringSize;
+	} // if
+
+	sq.ring = ::mmap( NULL, sq.ringSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING );
+	if ( sq.ring == MAP_FAILED ) {
+	    uAbort( "internal error, io_uring submission-queue mmap failure, error(%d) %s.", errno, strerror( errno ) );
+	} // if
+	if ( params.features & IORING_FEAT_SINGLE_MMAP ) {
+	    cq.ring = sq.ring;
+	} else {
+	    cq.ring = ::mmap( NULL, cq.ringSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING );
+	    if ( cq.ring == MAP_FAILED ) {
+		uAbort( "internal error, io_uring completion-queue mmap failure, error(%d) %s.", errno, strerror( errno ) );
+	    } // if
+	} // if
+	sq.sqes = (io_uring_sqe *)::mmap( NULL, params.sq_entries * sizeof( io_uring_sqe ), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES );
+	if ( sq.sqes == MAP_FAILED ) {
+	    uAbort( "internal error, io_uring submission-entry mmap failure, error(%d) %s.", errno, strerror( errno ) );
+	} // if
+
+	char *sqring = (char *)sq.ring, *cqring = (char *)cq.ring;
+	sq.head = (unsigned int *)(sqring + params.sq_off.head);
+	sq.tail = (unsigned int *)(sqring + params.sq_off.tail);
+	sq.mask = (unsigned int *)(sqring + params.sq_off.ring_mask);
+	sq.array = (unsigned int *)(sqring + params.sq_off.array);
+	cq.head = (unsigned int *)(cqring + params.cq_off.head);
+	cq.tail = (unsigned int *)(cqring + params.cq_off.tail);
+	cq.mask = (unsigned int *)(cqring + params.cq_off.ring_mask);
+	cq.cqes = (io_uring_cqe *)(cqring + params.cq_off.cqes);
+
+	eventFd = ::eventfd( 0, EFD_NONBLOCK | EFD_CLOEXEC );
+	if ( eventFd == -1 ) {
+	    uAbort( "internal error, io_uring eventfd failure, error(%d) %s.", errno, strerror( errno ) );
+	} // if
+	if ( ::syscall( __NR_io_uring_register, fd, IORING_REGISTER_EVENTFD, &eventFd, 1 ) == -1 ) {
+	    uAbort( "internal error, io_uring eventfd registration failure, error(%d) %s.", errno, strerror( errno ) );
+	} // if
+
+	ringFd = fd;					// usable
+    } // uIOuring::uIOuring
+
+
+    uIOuring::~uIOuring() {
+      if ( ringFd == -1 ) return;
+	::munmap( sq.sqes, ( *sq.mask + 1 ) * sizeof( io_uring_sqe ) ); // entries == mask + 1
+	if ( cq.ring != sq.ring ) ::munmap( cq.ring, cq.ringSize );
+	::munmap( sq.ring, sq.ringSize );
+	::close( eventFd );
+	::close( ringFd );
+    } // uIOuring::~uIOuring
+
+
+    int uIOuring::submit( unsigned char opcode, int fd, const void *addr, unsigned int len, unsigned long long int offset ) {
+	uIOuringRequest request;
+
+	slots.P();					// bound operations in flight so neither queue overflows
+
+	sqLock.acquire();
+	unsigned int tail = *sq.tail;
+	unsigned int index = tail & *sq.mask;
+	io_uring_sqe *sqe = &sq.sqes[index];
+	memset( sqe, 0, sizeof( *sqe ) );
+	sqe->opcode = opcode;
+	sqe->fd = fd;
+	sqe->off = offset;
+	sqe->addr = (unsigned long int)addr;
+	sqe->len = len;
+	sqe->user_data = (unsigned long int)&request;
+	sq.array[index] = index;
+	__sync_synchronize();				// entry must be visible before the tail moves
+	*(volatile unsigned int *)sq.tail = tail + 1;
+	queued += 1;
+	// Submit now if the batch is full or no other task can run to add to it.
+	bool now = queued >= Batch || uThisCluster().readyQueueEmpty();
+	sqLock.release();
+
+#ifdef __U_STATISTICS__
+	uFetchAdd( UPP::Statistics::uring_operations, 1 );
+#endif // __U_STATISTICS__
+
+	if ( now ) flush();
+	request.done.P();				// wait for completion
+
+#ifdef __U_DEBUG_H__
+	uDebugPrt( "(uIOuring &)%p.submit, opcode %d, fd %d, result %d\n", this, opcode, fd, request.result );
+#endif // __U_DEBUG_H__
+
+	if ( request.result < 0 ) {
+	    errno = -request.result;
+	    return -1;
+	} // if
+	return request.result;
+    } // uIOuring::submit
+
+
+    void uIOuring::flush() {
+	sqLock.acquire();
+	unsigned int n = queued;
+	queued = 0;
+	cycles = 0;
+	sqLock.release();
+      if ( n == 0 ) return;				// another processor submitted the batch
+
+	int submitted;
+	for ( ;; ) {
+	    submitted = ::syscall( __NR_io_uring_enter, ringFd, n, 0, 0, NULL, 0 );
+	  if ( submitted != -1 || errno != EINTR ) break;
+	} // for
+
+#ifdef __U_STATISTICS__
+	uFetchAdd( UPP::Statistics::uring_submits, 1 );
+#endif // __U_STATISTICS__
+
+	if ( submitted == -1 ) {
+	    if ( errno != EAGAIN && errno != EBUSY ) {	// EAGAIN/EBUSY => OS resources low, resubmit later
+		uAbort( "internal error, io_uring submission failure, error(%d) %s.", errno, strerror( errno ) );
+	    } // if
+	    submitted = 0;
+	} // if
+	if ( (unsigned int)submitted < n ) {		// resubmit remainder on next flush
+	    sqLock.acquire();
+	    queued += n - submitted;
+	    sqLock.release();
+	} // if
+    } // uIOuring::flush
+
+
+    void uIOuring::reap() {
+	uIOuringRequest *finished[Entries];		// at most Entries operations in flight
+	unsigned int n = 0;
+	eventfd_t count;
+
+	::eventfd_read( eventFd, &count );		// reset before draining, so a later completion signals again
+
+	cqLock.acquire();
+	unsigned int head = *cq.head;
+	unsigned int tail = *(volatile unsigned int *)cq.tail;
+	__sync_synchronize();				// read entries after the tail
+	for ( ; head != tail; head += 1, n += 1 ) {
+	    io_uring_cqe *cqe = &cq.cqes[head & *cq.mask];
+	    finished[n] = (uIOuringRequest *)(unsigned long int)cqe->user_data;
+	    finished[n]->result = cqe->res;
+	} // for
+	__sync_synchronize();				// entries consumed before the head moves
+	*(volatile unsigned int *)cq.head = head;
+	cqLock.release();
+
+      if ( n == 0 ) return;
+
+#ifdef __U_STATISTICS__
+	uFetchAdd( UPP::Statistics::uring_completions, n );
+#endif // __U_STATISTICS__
+
+	// Wake tasks after releasing the spin lock; a woken task may delete its request before V returns.
+	for ( unsigned int i = 0; i < n; i += 1 ) {
+	    finished[i]->done.V();
+	} // for
+	slots.V( n );
+    } // uIOuring::reap
+
+
+    void uIOuring::poll( bool idle ) {
+	if ( queued != 0 && ( idle || ( cycles += 1 ) >= Batch ) ) flush();
+	if ( completions() ) reap();
+    } // uIOuring::poll
+
+
+    int uIOuring::read( int fd, void *buf, unsigned int len ) {
+	return submit( IORING_OP_READ, fd, buf, len, (unsigned long long int)-1 );
+    } // uIOuring::read
+
+
+    int uIOuring::write( int fd, const void *buf, unsigned int len ) {
+	return submit( IORING_OP_WRITE, fd, buf, len, (unsigned long long int)-1 );
+    } // uIOuring::write
+
+
+    int uIOuring::readv( int fd, const struct iovec *iov, int iovcnt ) {
+	return submit( IORING_OP_READV, fd, iov, iovcnt, (unsigned long long int)-1 );
+    } // uIOuring::readv
+
+
+    int uIOuring::writev( int fd, const struct iovec *iov, int iovcnt ) {
+	return submit( IORING_OP_WRITEV, fd, iov, iovcnt, (unsigned long long int)-1 );
+    } // uIOuring::writev
+
+
+    int uIOuring::fsync( int fd ) {
+	return submit( IORING_OP_FSYNC, fd, NULL, 0, 0 ); // offset 0, length 0 => entire file
+    } // uIOuring::fsync
+} // UPP
+
+#endif // __U_IO_URING__
+
+
+// Local Variables: //
+// compile-command: "make install" //
+// End: //
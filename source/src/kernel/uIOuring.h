@@ -0,0 +1,112 @@
+//                              -*- Mode: C++ -*-
+//
+// uC++ Version 6.1.0, Copyright (C) agent 2026
+//
+// uIOuring.h -- asynchronous disk I/O through an io_uring per cluster
+//
+// Author           : agent
+// Created On       : Sun Oct 18 05:39:46 2026
+// Last Modified By : agent
+// Last Modified On : Sun Oct 18 06:36:17 2026
+// Update Count     : 3
+//
+// This  library is free  software; you  can redistribute  it and/or  modify it
+// under the terms of the GNU Lesser General Public License as published by the
+// Free Software  Foundation; either  version 2.1 of  the License, or  (at your
+// option) any later version.
+//
+// This library is distributed in the  hope that it will be useful, but WITHOUT
+// ANY  WARRANTY;  without even  the  implied  warranty  of MERCHANTABILITY  or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+// for more details.
+//
+// You should  have received a  copy of the  GNU Lesser General  Public License
+// along  with this library.
+//
+
+
+#ifndef __U_IOURING_H__
+#define __U_IOURING_H__
+
+#if defined( __U_IO_URING__ )
+
+#pragma __U_NOT_USER_CODE__
+
+
+struct iovec;						// forward declaration
+struct io_uring_sqe;					// forward declaration
+struct io_uring_cqe;					// forward declaration
+
+
+// Operations on descriptors that cannot be polled (regular files and block devices) block the kernel thread, and hence,
+// every task on the processor. Instead, such operations are placed on the cluster's io_uring and only the calling task
+// blocks until the completion is reaped by a processor of the cluster. The ring is created by the cluster's first such
+// operation. Submissions are batched: the submission system call is made when the ready queue is empty, when Batch
+// operations are queued, or after Batch passes through the scheduler with operations queued. Each routine returns the
+// system-call result, or -1 with errno set.
+
+namespace UPP {
+    class uIOuring {
+	friend class ::uCluster;			// access: uIOuring, ~uIOuring, eventFd, reap
+	friend _Coroutine uProcessorKernel;		// access: poll
+
+	enum { Entries = 128,				// submission-queue entries, bounds operations in flight
+	       Batch = 16 };				// operations queued before submission under load
+
+	int ringFd;					// io_uring descriptor, -1 => io_uring unavailable
+	int eventFd;					// signalled on each completion, wakes paused processors
+
+	struct {					// submission queue, shared with the OS
+	    unsigned int *head, *tail, *mask, *array;
+	    io_uring_sqe *sqes;
+	    void *ring;
+	    size_t ringSize;
+	} sq;
+	struct {					// completion queue, shared with the OS
+	    unsigned int *head, *tail, *mask;
+	    io_uring_cqe *cqes;
+	    void *ring;
+	    size_t ringSize;
+	} cq;
+
+	uSpinLock sqLock;				// mutual exclusion for submission-queue tail
+	uSpinLock cqLock;				// mutual exclusion for completion-queue head
+	uSemaphore slots;				// free submission slots, blocks tasks rather than overflow the ring
+	volatile unsigned int queued;			// operations on the submission queue not yet submitted
+	unsigned int cycles;				// scheduler passes since the oldest queued operation
+
+	uIOuring();
+	~uIOuring();
+
+	bool completions() const {			// unreaped completions ?
+	    return *(volatile unsigned int *)cq.head != *(volatile unsigned int *)cq.tail;
+	} // uIOuring::completions
+
+	int submit( unsigned char opcode, int fd, const void *addr, unsigned int len, unsigned long long int offset );
+	void flush();
+	void reap();
+	void poll( bool idle );
+      public:
+	bool usable() const {
+	    return ringFd != -1;
+	} // uIOuring::usable
+
+	int read( int fd, void *buf, unsigned int len );
+	int write( int fd, const void *buf, unsigned int len );
+	int readv( int fd, const struct iovec *iov, int iovcnt );
+	int writev( int fd, const struct iovec *iov, int iovcnt );
+	int fsync( int fd );
+    }; // uIOuring
+} // UPP
+
+
+#pragma __U_USER_CODE__
+
+#endif // __U_IO_URING__
+
+#endif // __U_IOURING_H__
+
+
+// Local Variables: //
+// compile-command: "make install" //
+// End: //
@@ -362,35 +362,86 @@ namespace UPP {
 	`-----------------' / <--- limit (16 byte align)
 	0/8                   <--- storage
 	,-----------------.
-	|   guard page    |   debug only
+	|   guard page    |   debug or mmap only
 	| write protected |
 	`-----------------'   <--- 4/8/16K alignment
     **************************************************************/
 
+
+    bool uMachContext::stackMmap( unsigned int size ) {
+	unsigned int threshold = uDefaultStackMmap();
+	return threshold != 0 && size >= threshold;
+    } // uMachContext::stackMmap
+
+
+    size_t uMachContext::stackGuard( unsigned int size ) {
+#ifdef __U_DEBUG__
+	return pageSize;
+#else
+	return stackMmap( size ) ? pageSize : 0;
+#endif // __U_DEBUG__
+    } // uMachContext::stackGuard
+
+
+    size_t uMachContext::stackExtent( unsigned int size ) {
+	return pageSize + uCeiling( uCeiling( sizeof(__U_CONTEXT_T__), 8 ) + size, pageSize );
+    } // uMachContext::stackExtent
+
+
+    void uMachContext::releaseStorage( void *storage, unsigned int size ) {
+	// Return the pages of a cached mmap stack to the operating system, except the first page holding the cache link
+	// and the last page holding the context, which the next task touches immediately. The reservation remains, so
+	// released pages are committed again on touch.
+
+	char *start = (char *)storage + 2 * pageSize;
+	char *end = (char *)storage + stackExtent( size ) - pageSize;
+	if ( start < end ) {
+	    ::madvise( start, end - start, MADV_DONTNEED );
+	} // if
+    } // uMachContext::releaseStorage
+
     void uMachContext::createContext( unsigned int storageSize ) { // used by all constructors
 	size_t cxtSize = uCeiling( sizeof(__U_CONTEXT_T__), 8 ); // minimum alignment
 
 	if ( storage == NULL ) {
 	    userStack = false;
 	    size = uCeiling( storageSize, 16 );
-	    // use malloc/memalign because "new" raises an exception for out-of-memory
-#ifdef __U_DEBUG__
-	    storage = memalign( pageSize, cxtSize + size + pageSize );
-	    if ( ::mprotect( storage, pageSize, PROT_NONE ) == -1 ) {
-		uAbort( "(uMachContext &)%p.createContext() : internal error, mprotect failure, error(%d) %s.", this, errno, strerror( errno ) );
+	    uCluster *cluster = THREAD_GETMEM( activeCluster ); // NULL during boot
+	    if ( cluster != NULL ) {
+		storage = cluster->stackCacheGet( size ); // reuse stack of deleted task/coroutine
 	    } // if
-#else
-	    // assume malloc has 8 byte alignment so add 8 to allow rounding up to 16 byte alignment
-	    storage = malloc( cxtSize + size + 8 );
-#endif // __U_DEBUG__
-	    if ( storage == NULL ) {
-		uAbort( "Attempt to allocate %d bytes of storage for coroutine or task execution-state but insufficient memory available.", size );
+	    if ( storage == NULL && stackMmap( size ) ) {
+		// Reserve address space without committing swap; pages are committed on first touch. The guard page stays
+		// write protected for the life of the mapping, including while the stack is cached.
+		storage = ::mmap( NULL, stackExtent( size ), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0 );
+		if ( storage == MAP_FAILED ) {
+		    uAbort( "Attempt to reserve %d bytes of storage for coroutine or task execution-state but insufficient address space available, error(%d) %s.", size, errno, strerror( errno ) );
+		} // if
+		if ( ::mprotect( storage, pageSize, PROT_NONE ) == -1 ) {
+		    uAbort( "(uMachContext &)%p.createContext() : internal error, mprotect failure, error(%d) %s.", this, errno, strerror( errno ) );
+		} // if
 	    } // if
+	    if ( storage == NULL ) {
+		// use malloc/memalign because "new" raises an exception for out-of-memory
 #ifdef __U_DEBUG__
-	    limit = (char *)storage + pageSize;
+		storage = memalign( pageSize, cxtSize + size + pageSize );
+		if ( storage != NULL && ::mprotect( storage, pageSize, PROT_NONE ) == -1 ) {
+		    uAbort( "(uMachContext &)%p.createContext() : internal error, mprotect failure, error(%d) %s.", this, errno, strerror( errno ) );
+		} // if
 #else
-	    limit = (char *)uCeiling( (unsigned long)storage, 16 ); // minimum alignment
+		// assume malloc has 8 byte alignment so add 8 to allow rounding up to 16 byte alignment
+		storage = malloc( cxtSize + size + 8 );
 #endif // __U_DEBUG__
+		if ( storage == NULL ) {
+		    uAbort( "Attempt to allocate %d bytes of storage for coroutine or task execution-state but insufficient memory available.", size );
+		} // if
+	    } // if
+	    size_t guard = stackGuard( size );
+	    if ( guard != 0 ) {
+		limit = (char *)storage + guard;
+	    } else {
+		limit = (char *)uCeiling( (unsigned long)storage, 16 ); // minimum alignment
+	    } // if
 	} else {
 #ifdef __U_DEBUG__
 	    if ( ((size_t)storage & (uAlign() - 1)) != 0 ) { // multiple of uAlign ?
@@ -416,6 +467,33 @@ namespace UPP {
     } // uMachContext::createContext
 
 
+    uMachContext::~uMachContext() {
+	if ( ! userStack ) {
+	    // Keep the stack, with its guard page still protected, for the next task or coroutine created on this cluster.
+	    uCluster *cluster = THREAD_GETMEM( activeCluster );
+	    if ( cluster == NULL || ! cluster->stackCachePut( storage, size ) ) {
+		freeStorage( storage, size );
+	    } // if
+	} // if
+    } // uMachContext::~uMachContext
+
+
+    void uMachContext::freeStorage( void *storage, unsigned int size ) {
+	if ( stackMmap( size ) ) {
+	    if ( ::munmap( storage, stackExtent( size ) ) == -1 ) {
+		uAbort( "uMachContext::freeStorage( %p, %d ) : internal error, munmap failure, error(%d) %s.", storage, size, errno, strerror( errno ) );
+	    } // if
+	    return;
+	} // if
+#ifdef __U_DEBUG__
+	if ( ::mprotect( storage, pageSize, PROT_READ | PROT_WRITE ) == -1 ) {
+	    uAbort( "uMachContext::freeStorage( %p, %d ) : internal error, mprotect failure, error(%d) %s.", storage, size, errno, strerror( errno ) );
+	} // if
+#endif // __U_DEBUG__
+	free( storage );
+    } // uMachContext::freeStorage
+
+
     void *uMachContext::stackPointer() const {
 	if ( &uThisCoroutine() == this ) {		// accessing myself ?
 	    void *sp;					// use my current stack value
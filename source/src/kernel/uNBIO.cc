@@ -50,6 +50,10 @@ using std::min;
 #if defined( __linux__ ) || defined( __freebsd__ )
 #include <sys/param.h>					// howmany
 #endif
+#if defined( __U_EPOLL__ )
+#include <sys/epoll.h>
+#include <unistd.h>					// close
+#endif // __U_EPOLL__
 
 
 namespace UPP {
@@ -168,15 +172,480 @@ namespace UPP {
 
 
     void uNBIO::uSelectTimeoutHndlr::handler() {
+#if defined( __U_PROCESSOR_POLLERS__ )
+	cluster.NBIO->timeout( node );			// no poller task to wake
+#else
+#if defined( __U_EPOLL__ )
+	node.timedout = true;
+	if ( node.fdType == NBIOnode::singleFd ) {	// tasks waiting on a single fd are found through the fd
+	    cluster.NBIO->expire( node.smfd.sfd.closure->access.fd );
+	} // if
+	*node.nbioTimeout = true;			// set after recording fd so poller finds it
+#else
 	*node.nbioTimeout = node.timedout = true;
+#endif // __U_EPOLL__
 	uPid_t temp = cluster.NBIO->IOPollerPid;	// race: IOPollerPid can change to -1 if poller wakes before wakeup
 	if ( temp != (uPid_t)-1 ) cluster.wakeProcessor( temp );
+#endif // __U_PROCESSOR_POLLERS__
     } // uNBIO::uSelectTimeoutHndlr::handler
 
 
     //######################### uNBIO #########################
 
 
+#if defined( __U_EPOLL__ )
+    uNBIO::FdState &uNBIO::fdState( int fd ) {
+	unsigned int chunk = fd / FdChunk;
+	FdTable *table = fdTable;
+
+	if ( chunk >= table->size || table->chunks[chunk] == NULL ) { // table too small or chunk not allocated ?
+	    extendFdTable( chunk );
+	    table = fdTable;
+	} // if
+	return table->chunks[chunk][fd % FdChunk];
+    } // uNBIO::fdState
+
+
+    void uNBIO::extendFdTable( unsigned int chunk ) {
+	// Readers index the table without locking, so a table replaced by a larger one is kept until the cluster is
+	// deleted, and chunks are shared by the tables and never freed, so FdState addresses are stable. Storage is
+	// allocated outside the lock, and tables are only changed through the current table while holding the lock, so a
+	// chunk cannot be installed in a table after it is copied.
+
+	for ( ;; ) {
+	    FdTable *table = fdTable;
+	  if ( chunk < table->size && table->chunks[chunk] != NULL ) break;
+	    if ( chunk >= table->size ) {		// grow table ?
+		unsigned int size = table->size * 2;
+		while ( size <= chunk ) size *= 2;
+		FdTable *larger = new FdTable( size );
+		fdTableLock.acquire();
+		if ( fdTable == table ) {		// table not grown by another task ?
+		    for ( unsigned int i = 0; i < table->size; i += 1 ) {
+			larger->chunks[i] = table->chunks[i];
+		    } // for
+		    larger->prev = table;
+		    fdTable = larger;
+		    larger = NULL;
+		} // if
+		fdTableLock.release();
+		delete larger;
+	    } else {					// allocate chunk
+		FdState *states = new FdState[FdChunk];
+		fdTableLock.acquire();
+		if ( fdTable == table && table->chunks[chunk] == NULL ) { // chunk not allocated by another task ?
+		    table->chunks[chunk] = states;
+		    states = NULL;
+		} // if
+		fdTableLock.release();
+		delete [] states;
+	    } // if
+	} // for
+    } // uNBIO::extendFdTable
+
+
+    void uNBIO::deleteFdTable() {
+	for ( unsigned int i = 0; i < fdTable->size; i += 1 ) {
+	    delete [] fdTable->chunks[i];
+	} // for
+	for ( FdTable *table = fdTable; table != NULL; ) {
+	    FdTable *prev = table->prev;
+	    delete table;
+	    table = prev;
+	} // for
+    } // uNBIO::deleteFdTable
+
+
+    int uNBIO::registerFD( int fd ) {
+	epoll_event event;
+	event.events = EPOLLIN | EPOLLOUT | EPOLLPRI | EPOLLRDHUP | EPOLLET;
+	event.data.u64 = 0;
+	event.data.fd = fd;
+
+	fdState( fd );					// events only arrive for descriptors with a state
+#ifdef __U_STATISTICS__
+	uFetchAdd( Statistics::epoll_ctls, 1 );
+	if ( (unsigned int)fd >= Statistics::epoll_maxFD ) Statistics::epoll_maxFD = fd + 1;
+#endif // __U_STATISTICS__
+#if defined( __U_PROCESSOR_POLLERS__ )
+	if ( ::epoll_ctl( shards[fd % Shards].epollFd, EPOLL_CTL_ADD, fd, &event ) == -1 ) {
+#else
+	if ( ::epoll_ctl( epollFd, EPOLL_CTL_ADD, fd, &event ) == -1 ) {
+#endif // __U_PROCESSOR_POLLERS__
+#ifdef __U_DEBUG_H__
+	    uDebugPrt( "(uNBIO &)%p.registerFD, fd %d, error(%d) %s\n", this, fd, errno, strerror( errno ) );
+#endif // __U_DEBUG_H__
+	    return errno;				// EEXIST => already registered, EPERM => fd cannot be polled
+	} // if
+	return 0;
+    } // uNBIO::registerFD
+
+
+    void uNBIO::registerMfds( unsigned int nfds, NBIOnode &node ) {
+	// The masks give no uPoll to remember the registration, and a user descriptor may be closed and its number reused
+	// without the runtime knowing, so every descriptor is added on each wait, where EEXIST means already registered.
+
+	for ( unsigned int fd = 0; fd < nfds; fd += 1 ) {
+	    if ( ( node.smfd.mfd.trfds != NULL && FD_ISSET( fd, node.smfd.mfd.trfds ) ) ||
+		 ( node.smfd.mfd.twfds != NULL && FD_ISSET( fd, node.smfd.mfd.twfds ) ) ||
+		 ( node.smfd.mfd.tefds != NULL && FD_ISSET( fd, node.smfd.mfd.tefds ) ) ) {
+		registerFD( fd );
+	    } // if
+	} // for
+    } // uNBIO::registerMfds
+
+
+    int uNBIO::pollMfds( NBIOnode &node ) {
+	// Edges are not remembered for multiple fds because the caller performs the I/O directly, so the user masks are
+	// checked level-triggered with a zero-timeout pselect, which also produces the result masks.
+
+	static timespec timeout_ = { 0, 0 };
+	fd_set rfds, wfds, efds;
+	size_t len = howmany( node.smfd.mfd.tnfds, NFDBITS ) * sizeof( fd_mask );
+	int cnt;
+
+	if ( node.smfd.mfd.trfds != NULL ) memcpy( &rfds, node.smfd.mfd.trfds, len );
+	if ( node.smfd.mfd.twfds != NULL ) memcpy( &wfds, node.smfd.mfd.twfds, len );
+	if ( node.smfd.mfd.tefds != NULL ) memcpy( &efds, node.smfd.mfd.tefds, len );
+	for ( ;; ) {
+	    cnt = ::pselect( node.smfd.mfd.tnfds,
+			     node.smfd.mfd.trfds != NULL ? &rfds : NULL,
+			     node.smfd.mfd.twfds != NULL ? &wfds : NULL,
+			     node.smfd.mfd.tefds != NULL ? &efds : NULL, &timeout_, NULL );
+	  if ( cnt != -1 || errno != EINTR ) break;	// timer interrupt ?
+	} // for
+	if ( cnt > 0 ) {				// copy result masks
+	    if ( node.smfd.mfd.trfds != NULL ) memcpy( node.smfd.mfd.trfds, &rfds, len );
+	    if ( node.smfd.mfd.twfds != NULL ) memcpy( node.smfd.mfd.twfds, &wfds, len );
+	    if ( node.smfd.mfd.tefds != NULL ) memcpy( node.smfd.mfd.tefds, &efds, len );
+	} // if
+	return cnt;					// -1 => bad fd in mask, task retries and gets the error
+    } // uNBIO::pollMfds
+#endif // __U_EPOLL__
+
+
+#if defined( __U_PROCESSOR_POLLERS__ )
+    unsigned int uNBIO::shardCounter = 0;
+
+
+    void uNBIO::timeout( NBIOnode &node ) {
+	// Called from the timeout handler, and therefore, cannot block, but it can spin.
+
+	uSpinLock &lock = node.fdType == NBIOnode::singleFd ? shards[node.smfd.sfd.closure->access.fd % Shards].lock : mfdLock;
+	lock.acquire();
+	node.timedout = true;
+	bool waiting = node.listed();
+	if ( waiting ) {				// remove the task so it sees the timeout
+	    if ( node.fdType == NBIOnode::singleFd ) {
+		int fd = node.smfd.sfd.closure->access.fd;
+		fdState( fd ).waiting.remove( &node );
+		shards[fd % Shards].waiters -= 1;
+	    } else {
+		pendingIOMfds.remove( &node );
+	    } // if
+	    uFetchAdd( pending, -1 );
+	} // if
+	lock.release();
+	if ( waiting ) node.pending.V();		// node may be deallocated after wakeup
+    } // uNBIO::timeout
+
+
+    void uNBIO::pollShard( Shard &shard ) {
+	// Called from the scheduler loop, and therefore, cannot block, but it can spin.
+
+	epoll_event events[EventsPerPoll];
+	int cnt;
+
+	for ( ;; ) {
+	    cnt = ::epoll_wait( shard.epollFd, events, EventsPerPoll, 0 );
+	  if ( cnt != -1 || errno != EINTR ) break;	// timer interrupt ?
+#ifdef __U_STATISTICS__
+	    uFetchAdd( Statistics::epoll_eintr, 1 );
+#endif // __U_STATISTICS__
+	} // for
+#ifdef __U_STATISTICS__
+	uFetchAdd( Statistics::epoll_waits, 1 );
+#endif // __U_STATISTICS__
+      if ( cnt <= 0 ) {
+#ifdef __U_STATISTICS__
+	    if ( cnt == 0 ) uFetchAdd( Statistics::epoll_nothing, 1 );
+	    else uFetchAdd( Statistics::epoll_errors, 1 );
+#endif // __U_STATISTICS__
+	    return;
+	} // if
+#ifdef __U_STATISTICS__
+	uFetchAdd( Statistics::epoll_events, cnt );
+#endif // __U_STATISTICS__
+
+	// Tasks are woken after the locks are released. A removed node stays valid until its task is woken.
+
+	uSequence<NBIOnode> woken;
+	NBIOnode *p;
+
+	shard.lock.acquire();
+	for ( int i = 0; i < cnt; i += 1 ) {
+	    unsigned int ev = events[i].events;
+	    int rwe = 0;
+
+	    // Hangup and error make any operation complete, so the waiting task sees end-of-file or the error.
+	    if ( ev & ( EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR ) ) rwe |= uCluster::ReadSelect;
+	    if ( ev & ( EPOLLOUT | EPOLLHUP | EPOLLERR ) ) rwe |= uCluster::WriteSelect;
+	    if ( ev & EPOLLPRI ) rwe |= uCluster::ExceptSelect;
+
+	    FdState &state = fdState( events[i].data.fd );
+	    state.ready |= rwe;
+	    state.edges += 1;
+	    for ( uSeqIter<NBIOnode> iter( state.waiting ); iter >> p; ) {
+		if ( *p->smfd.sfd.uRWE & rwe ) {	// event of interest to this task ?
+		    state.waiting.remove( p );
+		    shard.waiters -= 1;
+		    woken.addTail( p );
+		} // if
+	    } // for
+	} // for
+	shard.lock.release();
+
+	if ( ! pendingIOMfds.empty() ) {		// tasks waiting on multiple fds recheck if any of their fds has an event
+	    mfdLock.acquire();
+	    for ( uSeqIter<NBIOnode> iter( pendingIOMfds ); iter >> p; ) {
+		for ( int i = 0; i < cnt; i += 1 ) {
+		    int fd = events[i].data.fd;
+		    if ( (unsigned int)fd < p->smfd.mfd.tnfds &&
+			 ( ( p->smfd.mfd.trfds != NULL && FD_ISSET( fd, p->smfd.mfd.trfds ) ) ||
+			   ( p->smfd.mfd.twfds != NULL && FD_ISSET( fd, p->smfd.mfd.twfds ) ) ||
+			   ( p->smfd.mfd.tefds != NULL && FD_ISSET( fd, p->smfd.mfd.tefds ) ) ) ) {
+			pendingIOMfds.remove( p );
+			woken.addTail( p );
+			break;
+		    } // if
+		} // for
+	    } // for
+	    mfdLock.release();
+	} // if
+
+	while ( ( p = woken.dropHead() ) != NULL ) {
+#ifdef __U_DEBUG_H__
+	    uDebugPrt( "(uNBIO &)%p.pollShard, waking task %.256s (%p)\n", this, p->pendingTask->getName(), p->pendingTask );
+#endif // __U_DEBUG_H__
+	    uFetchAdd( pending, -1 );
+	    p->pending.V();				// node may be deallocated after wakeup
+	} // while
+    } // uNBIO::pollShard
+
+
+    void uNBIO::poll( unsigned int home, bool idle ) {
+	// Called from the scheduler loop. A busy processor polls its home shard first. Then every shard with events,
+	// found through the epoll set of shard sets, is polled, so shards without a home processor, because the cluster
+	// has fewer processors than shards or their home processors are busy, are serviced without an idle processor.
+
+      if ( pending == 0 ) return;			// no task waiting for I/O ?
+#ifdef __U_STATISTICS__
+	Statistics::epoll_pending = pending;
+#endif // __U_STATISTICS__
+
+	Shard *first = NULL;
+	if ( ! idle ) {
+	    first = &shards[home % Shards];
+	    if ( first->waiters != 0 ) pollShard( *first );
+	} // if
+
+	epoll_event events[Shards];
+	int cnt = ::epoll_wait( epollFd, events, Shards, 0 );
+	for ( int i = 0; i < cnt; i += 1 ) {
+	    Shard &shard = shards[events[i].data.u32];
+	    if ( &shard != first ) pollShard( shard ); // home shard just polled
+	} // for
+    } // uNBIO::poll
+
+
+    void uNBIO::waitOrPoll( NBIOnode &node, uEventNode *timeoutEvent ) {
+	int fd = node.smfd.sfd.closure->access.fd;	// optimization
+	uPoll &poll = node.smfd.sfd.closure->access.poll;
+	Shard &shard = shards[fd % Shards];
+	FdState &state = fdState( fd );
+	int rwe;
+	unsigned int edges;
+
+	if ( poll.getEpoll() != shard.epollFd ) {	// not registered in this cluster's epoll sets ?
+	    shard.lock.acquire();
+	    edges = state.edges;
+	    shard.lock.release();
+	    switch ( registerFD( fd ) ) {
+	      case 0:					// new registration
+		shard.lock.acquire();
+		if ( state.edges == edges ) state.ready = 0; // edges belong to a previous descriptor with the same number
+		shard.lock.release();
+		// FALL THROUGH
+	      case EEXIST:
+		poll.setEpoll( shard.epollFd );
+		break;
+	      default:					// cannot be polled (e.g., regular file) so always ready
+		state.ready = uCluster::ReadSelect | uCluster::WriteSelect | uCluster::ExceptSelect;
+	    } // switch
+	} // if
+
+	if ( timeoutEvent != NULL ) {
+	    timeoutEvent->add();
+	} // if
+
+	for ( ;; ) {
+	    shard.lock.acquire();
+	    rwe = *node.smfd.sfd.uRWE & state.ready;
+	    edges = state.edges;
+	    if ( rwe == 0 ) {				// no edge to consume ?
+		if ( node.timedout ) {			// set by timeout handler or polling
+		    shard.lock.release();
+		    node.nfds = 0;			// set return value
+		    return;
+		} // if
+#ifdef __U_DEBUG_H__
+		uDebugPrt( "(uNBIO &)%p.waitOrPoll, adding node %p for fd %d\n", this, &node, fd );
+#endif // __U_DEBUG_H__
+		state.waiting.addTail( &node );		// node is removed by a polling processor or the timeout handler
+		shard.waiters += 1;
+		uFetchAdd( pending, 1 );
+		shard.lock.release();
+		node.pending.P();			// wait for an event on the descriptor
+		continue;
+	    } // if
+	    shard.lock.release();
+
+	    node.smfd.sfd.closure->wrapper();		// an edge is reported, so perform the operation
+	    if ( node.smfd.sfd.closure->retcode != -1 || node.smfd.sfd.closure->errno_ != U_EWOULDBLOCK ) {
+		*node.smfd.sfd.uRWE = rwe;
+		node.nfds = countBits( rwe );		// set return value
+		return;
+	    } // if
+
+	    shard.lock.acquire();
+	    if ( state.edges == edges ) state.ready &= ~rwe; // edge consumed, unless another arrived during the operation
+	    shard.lock.release();
+	} // for
+    } // uNBIO::waitOrPoll
+
+
+    void uNBIO::waitOrPoll( unsigned int nfds, NBIOnode &node, uEventNode *timeoutEvent ) {
+	registerMfds( nfds, node );
+
+	if ( timeoutEvent != NULL ) {
+	    timeoutEvent->add();
+	} // if
+
+	for ( ;; ) {
+	    // The node is queued before the level check, so an event during the check wakes the task.
+
+	    mfdLock.acquire();
+	    pendingIOMfds.addTail( &node );		// node is removed by a polling processor or the timeout handler
+	    uFetchAdd( pending, 1 );
+	    mfdLock.release();
+
+	    int cnt = pollMfds( node );
+
+	    mfdLock.acquire();
+	    bool waiting = node.listed();
+	    if ( waiting && ( cnt != 0 || node.timedout ) ) { // I/O possible or timed out ?
+		pendingIOMfds.remove( &node );
+		uFetchAdd( pending, -1 );
+	    } // if
+	    mfdLock.release();
+
+	    if ( waiting ) {
+		if ( cnt != 0 || node.timedout ) {
+		    node.nfds = cnt;			// set return value
+		    return;
+		} // if
+		node.pending.P();			// wait for an event on one of the descriptors or the timeout
+	    } else {
+		node.pending.P();			// consume wakeup from polling processor or timeout handler
+		if ( cnt != 0 ) {
+		    node.nfds = cnt;			// set return value
+		    return;
+		} // if
+	    } // if
+	    if ( node.timedout ) {
+		node.nfds = 0;				// set return value
+		return;
+	    } // if
+	} // for
+    } // uNBIO::waitOrPoll
+
+
+    uNBIO::uNBIO() {
+#ifdef __U_DEBUG_H__
+	uDebugPrt( "(uNBIO &)%p.uNBIO\n", this );
+#endif // __U_DEBUG_H__
+	epollFd = ::epoll_create1( EPOLL_CLOEXEC );	// set of shard sets
+	if ( epollFd == -1 ) {
+	    uAbort( "(uNBIO &)%p.uNBIO() : internal error, epoll_create1 failed, error(%d) %s.", this, errno, strerror( errno ) );
+	} // if
+	for ( unsigned int i = 0; i < Shards; i += 1 ) {
+	    shards[i].epollFd = ::epoll_create1( EPOLL_CLOEXEC );
+	    if ( shards[i].epollFd == -1 ) {
+		uAbort( "(uNBIO &)%p.uNBIO() : internal error, epoll_create1 failed, error(%d) %s.", this, errno, strerror( errno ) );
+	    } // if
+	    shards[i].waiters = 0;
+
+	    epoll_event event;				// level-triggered, shard set is readable while it has events
+	    event.events = EPOLLIN;
+	    event.data.u64 = 0;
+	    event.data.u32 = i;
+	    if ( ::epoll_ctl( epollFd, EPOLL_CTL_ADD, shards[i].epollFd, &event ) == -1 ) {
+		uAbort( "(uNBIO &)%p.uNBIO() : internal error, epoll_ctl failed, error(%d) %s.", this, errno, strerror( errno ) );
+	    } // if
+	} // for
+	fdTable = new FdTable( FdChunks );		// descriptor chunks created on first use
+	watcher = NULL;
+	descriptors = 0;
+	pending = 0;
+	IOPoller = NULL;				// no poller task
+	IOPollerPid = (uPid_t)-1;
+	timeoutOccurred = false;
+    } // uNBIO::uNBIO
+
+
+    uNBIO::~uNBIO() {
+	for ( unsigned int i = 0; i < Shards; i += 1 ) {
+	    ::close( shards[i].epollFd );
+	} // for
+	::close( epollFd );
+	deleteFdTable();
+    } // uNBIO::~uNBIO
+#else
+#if defined( __U_EPOLL__ )
+    int uNBIO::select( sigset_t *old_mask ) {
+#ifdef __U_STATISTICS__
+	uFetchAdd( Statistics::epoll_waits, 1 );
+	Statistics::epoll_pending = pending;
+#endif // __U_STATISTICS__
+	assert( THREAD_GETMEM( disableInt ) );
+	descriptors = ::epoll_pwait( epollFd, events, EventsPerWait,
+				     selectBlock ? -1 : 0, old_mask ); // poll or block ?
+	IOPollerPid = (uPid_t)-1;
+	return errno;
+    } // uNBIO::select
+
+
+    void uNBIO::addWaiter( FdState &state, NBIOnode &node ) {
+	if ( state.waiting.empty() ) waitingFds.addTail( &state );
+	state.waiting.addTail( &node );			// node is removed by IOPoller
+    } // uNBIO::addWaiter
+
+
+    void uNBIO::removeWaiter( FdState &state, NBIOnode *p ) {
+	state.waiting.remove( p );			// remove node from list of waiting tasks
+	if ( state.waiting.empty() ) waitingFds.remove( &state );
+    } // uNBIO::removeWaiter
+
+
+    void uNBIO::expire( int fd ) {
+	// Called from the timeout handler, and therefore, cannot block, but it can spin.
+
+	expiredLock.acquire();
+	if ( expired < ExpiredMax ) expiredFds[expired] = fd;
+	if ( expired <= ExpiredMax ) expired += 1;	// ExpiredMax + 1 => overflow
+	expiredLock.release();
+    } // uNBIO::expire
+#else
     void uNBIO::checkIOStart() {
 	// Combine the single and multiple master masks to form the master mask.
 
@@ -223,6 +692,7 @@ namespace UPP {
 	IOPollerPid = (uPid_t)-1;
 	return errno;
     } // uNBIO::select
+#endif // __U_EPOLL__
 
 
     bool uNBIO::pollIO( NBIOnode &node ) {
@@ -231,7 +701,9 @@ namespace UPP {
 	// Note, select occurs outside of the mutex members of NBIO monitor, so that other tasks can enter the
 	// monitor and register their interest in other IO events.
 
+#if ! defined( __U_EPOLL__ )
 	checkIOStart();					// acquires mutual exclusion
+#endif // ! __U_EPOLL__
 
 	// This processor is about to become idle. First, interrupts are disabled because the following operations
 	// affect some kernel data structures.  Second, preemption is turned off because it is now controlled by the
@@ -291,7 +763,11 @@ namespace UPP {
 		    // set IOPollerPid so this processor is woken up by arriving I/O requests or timed-out I/O requests
 		    IOPollerPid = uThisProcessor().getPid();
 #ifdef __U_STATISTICS__
+#if defined( __U_EPOLL__ )
+		    uFetchAdd( Statistics::epoll_blocking, 1 );
+#else
 		    uFetchAdd( Statistics::select_blocking, 1 );
+#endif // __U_EPOLL__
 #endif // __U_STATISTICS__
 
 #if ! defined( __U_MULTI__ )
@@ -323,6 +799,84 @@ namespace UPP {
     } // uNBIO::pollIO
 
 
+#if defined( __U_EPOLL__ )
+    bool uNBIO::attemptIO( NBIOnode &node, FdState &state, int rwe ) {
+	// Perform the operation on behalf of the waiting task. If it would still block, the edge is consumed.
+
+	node.smfd.sfd.closure->wrapper();
+	if ( node.smfd.sfd.closure->retcode == -1 && node.smfd.sfd.closure->errno_ == U_EWOULDBLOCK ) {
+	    state.ready &= ~rwe;			// wait for next edge
+	    return false;
+	} // if
+	*node.smfd.sfd.uRWE = rwe;
+	node.nfds = countBits( rwe );			// set return value
+	return true;
+    } // uNBIO::attemptIO
+
+
+    void uNBIO::checkSfds( int fd, NBIOnode *p, FdState &state ) {
+	int rwe = *p->smfd.sfd.uRWE & state.ready;
+
+#ifdef __U_DEBUG_H__
+	uDebugPrt( "(uNBIO &)%p.checkSfds, found task %.256s (%p) waiting on single fd %d with mask 0x%x, ready 0x%x\n",
+		   this, p->pendingTask->getName(), p->pendingTask, fd, *p->smfd.sfd.uRWE, state.ready );
+#endif // __U_DEBUG_H__
+
+	if ( rwe != 0 && attemptIO( *p, state, rwe ) ) { // I/O performed on behalf of waiting task ?
+	    removeWaiter( state, p );
+	    p->pending.V();				// wake up waiting task (empty for IOPoller)
+	    pending -= 1;
+	} // if
+    } // uNBIO::checkSfds
+
+
+    void uNBIO::expireSfds( FdState &state ) {
+	NBIOnode *p;
+	for ( uSeqIter<NBIOnode> iter( state.waiting ); iter >> p; ) {
+	    if ( p->timedout ) {			// timed out waiting for I/O for this task ?
+#ifdef __U_DEBUG_H__
+		uDebugPrt( "(uNBIO &)%p.expireSfds, removing node %p for task %s (%p)\n", this, p, p->pendingTask->getName(), p->pendingTask );
+#endif // __U_DEBUG_H__
+		removeWaiter( state, p );
+		p->nfds = 0;				// set return value
+		p->pending.V();				// wake up waiting task (empty for IOPoller)
+		pending -= 1;
+	    } // if
+	} // for
+    } // uNBIO::expireSfds
+
+
+    void uNBIO::checkMfds() {
+	NBIOnode *p;
+
+	FD_ZERO( &mrfds );				// recompute master masks from tasks still waiting
+	FD_ZERO( &mwfds );
+	FD_ZERO( &mefds );
+	mmaxFD = 0;
+	for ( uSeqIter<NBIOnode> iter( pendingIOMfds ); iter >> p; ) {
+	    int cnt = pollMfds( *p );
+	    if ( cnt != 0 || p->timedout ) {		// I/O possible for this task or timed out (set by event handler) ?
+#ifdef __U_DEBUG_H__
+		uDebugPrt( "(uNBIO &)%p.checkMfds, removing node %p for task %s (%p), cnt:%d, timedout:%d\n",
+			   this, p, p->pendingTask->getName(), p->pendingTask, cnt, p->timedout );
+#endif // __U_DEBUG_H__
+		pendingIOMfds.remove( p );		// remove node from list of waiting tasks
+		p->nfds = cnt;				// set return value
+		p->pending.V();				// wake up waiting task (empty for IOPoller)
+		pending -= 1;
+	    } else {					// task is not waking up
+		unsigned int tmasks = howmany( p->smfd.mfd.tnfds, NFDBITS );
+		if ( p->smfd.mfd.trfds != NULL )
+		    for ( unsigned int i = 0; i < tmasks; i += 1 ) mrfds.fds_bits[i] |= p->smfd.mfd.trfds->fds_bits[i];
+		if ( p->smfd.mfd.twfds != NULL )
+		    for ( unsigned int i = 0; i < tmasks; i += 1 ) mwfds.fds_bits[i] |= p->smfd.mfd.twfds->fds_bits[i];
+		if ( p->smfd.mfd.tefds != NULL )
+		    for ( unsigned int i = 0; i < tmasks; i += 1 ) mefds.fds_bits[i] |= p->smfd.mfd.tefds->fds_bits[i];
+		if ( p->smfd.mfd.tnfds > mmaxFD ) mmaxFD = p->smfd.mfd.tnfds;
+	    } // if
+	} // for
+    } // uNBIO::checkMfds
+#else
     void uNBIO::performIO( int fd, NBIOnode *p, uSequence<NBIOnode> &pendingIO, int cnt ) {
 	p->smfd.sfd.closure->wrapper();
 	if ( p->smfd.sfd.closure->retcode == -1 && p->smfd.sfd.closure->errno_ == U_EWOULDBLOCK ) {
@@ -386,6 +940,7 @@ namespace UPP {
 	    pending -= 1;
 	} // if
     } // uNBIO::checkSfds
+#endif // __U_EPOLL__
 
 
     void uNBIO::unblockFD( uSequence<NBIOnode> &pendingIO ) {
@@ -402,6 +957,125 @@ namespace UPP {
     } // uNBIO::unblockFD
 
 
+#if defined( __U_EPOLL__ )
+    bool uNBIO::checkIOEnd( NBIOnode &node, int terrno ) {
+	NBIOnode *p;
+
+#ifdef __U_DEBUG_H__
+	uDebugPrt( "(uNBIO &)%p.checkIOEnd, epoll_wait returns: found %d\n", this, descriptors );
+#endif // __U_DEBUG_H__
+
+	if ( descriptors > 0 ) {			// I/O has occurred ?
+#ifdef __U_STATISTICS__
+	    uFetchAdd( Statistics::epoll_events, descriptors );
+#endif // __U_STATISTICS__
+
+	    // Only the descriptors with events are examined, and only the tasks waiting on those descriptors.
+
+	    bool multiples = false;
+	    for ( int i = 0; i < descriptors; i += 1 ) {
+		int fd = events[i].data.fd;
+		unsigned int ev = events[i].events;
+		int rwe = 0;
+
+		// Hangup and error make any operation complete, so the waiting task sees end-of-file or the error.
+		if ( ev & ( EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR ) ) rwe |= uCluster::ReadSelect;
+		if ( ev & ( EPOLLOUT | EPOLLHUP | EPOLLERR ) ) rwe |= uCluster::WriteSelect;
+		if ( ev & EPOLLPRI ) rwe |= uCluster::ExceptSelect;
+
+		FdState &state = fdState( fd );
+		state.ready |= rwe;
+		for ( uSeqIter<NBIOnode> iter( state.waiting ); iter >> p; ) {
+		    checkSfds( fd, p, state );
+		} // for
+
+		if ( (unsigned int)fd < mmaxFD && ( FD_ISSET( fd, &mrfds ) || FD_ISSET( fd, &mwfds ) || FD_ISSET( fd, &mefds ) ) ) {
+		    multiples = true;			// some task waiting on multiple fds is interested in this fd
+		} // if
+	    } // for
+	    if ( multiples ) checkMfds();
+	} else if ( descriptors == 0 ) {		// time limit expired, no IO is ready
+#ifdef __U_DEBUG_H__
+	    uDebugPrt( "(uNBIO &)%p.checkIOEnd, time limit expired\n", this );
+#endif // __U_DEBUG_H__
+#ifdef __U_STATISTICS__
+	    uFetchAdd( Statistics::epoll_nothing, 1 );
+#endif // __U_STATISTICS__
+	} else {
+#ifdef __U_DEBUG_H__
+	    uDebugPrt( "(uNBIO &)%p.checkIOEnd, error, errno:%d %s\n", this, terrno, strerror( terrno ) );
+#endif // __U_DEBUG_H__
+#ifdef __U_STATISTICS__
+	    uFetchAdd( Statistics::epoll_errors, 1 );
+#endif // __U_STATISTICS__
+	    // Unlike select, a bad descriptor never causes an error because closed descriptors are removed from the
+	    // epoll set, so the only expected error is EINTR.
+
+	    if ( terrno == EINTR ) {
+		// probably sigalrm from migrate, do nothing
+#ifdef __U_STATISTICS__
+		uFetchAdd( Statistics::epoll_eintr, 1 );
+#endif // __U_STATISTICS__
+	    } else {
+		uAbort( "(uNBIO &)%p.checkIOEnd() : internal error, epoll_wait error(%d) %s.", this, terrno, strerror( terrno ) );
+	    } // if
+	} // if
+
+	if ( timeoutOccurred ) {			// non-polling timeout ?
+	    timeoutOccurred = false;
+
+	    // Check for timed-out IO. Tasks waiting on a single fd are found through the fds recorded by the timeout
+	    // handler, unless too many timeouts occurred, in which case all waiting fds are checked.
+
+	    int fds[ExpiredMax];
+	    expiredLock.acquire();
+	    unsigned int cnt = expired;
+	    for ( unsigned int i = 0; i < cnt && i < ExpiredMax; i += 1 ) fds[i] = expiredFds[i];
+	    expired = 0;
+	    expiredLock.release();
+
+	    if ( cnt > ExpiredMax ) {			// overflow ?
+		FdState *state;
+		for ( uSeqIter<FdState> iter( waitingFds ); iter >> state; ) {
+		    expireSfds( *state );
+		} // for
+	    } else {
+		for ( unsigned int i = 0; i < cnt; i += 1 ) {
+		    expireSfds( fdState( fds[i] ) );
+		} // for
+	    } // if
+
+	    for ( uSeqIter<NBIOnode> iter( pendingIOMfds ); iter >> p; ) {
+		if ( p->timedout ) {			// timed out waiting for I/O for this task ?
+		    checkMfds();			// final check also removes timed-out tasks
+		    break;
+		} // if
+	    } // for
+	} // if
+
+	// If the IOPoller's I/O completed, attempt to nominate another waiting
+	// task to be the IOPoller.
+
+	if ( ! node.listed() ) {			// IOPoller's node removed ?
+	    if ( ! pendingIOMfds.empty() ) {		// any other tasks waiting for I/O event on a general FD mask?
+		unblockFD( pendingIOMfds );
+	    } else if ( ! waitingFds.empty() ) {	// any other tasks waiting for I/O event on a single FD ?
+		unblockFD( waitingFds.head()->waiting );
+	    } else {
+		IOPoller = NULL;
+	    } // if
+	    return false;
+	} else {
+#ifdef __U_STATISTICS__
+	    uFetchAdd( Statistics::iopoller_spin, 1 );
+#endif // __U_STATISTICS__
+#ifdef __U_DEBUG_H__
+	    uDebugPrt( "(uNBIO &)%p.checkIOEnd, poller %.256s (%p) continuing to poll\n", this, uThisTask().getName(), &uThisTask() );
+#endif // __U_DEBUG_H__
+	    return true;
+	} // if
+    } // uNBIO::checkIOEnd
+#else
     bool uNBIO::checkIOEnd( NBIOnode &node, int terrno ) {
 	unsigned int i, tcnt, cnt;
 	unsigned int tmasks;
@@ -735,6 +1409,7 @@ namespace UPP {
 	    return true;
 	} // if
     } // uNBIO::checkIOEnd
+#endif // __U_EPOLL__
 
 
     bool uNBIO::checkPoller() {
@@ -779,6 +1454,132 @@ namespace UPP {
     } // uNBIO::waitOrPoll
 
 
+#if defined( __U_EPOLL__ )
+    bool uNBIO::initSfd( NBIOnode &node, uEventNode *timeoutEvent ) {
+	int fd = node.smfd.sfd.closure->access.fd;	// optimization
+	uPoll &poll = node.smfd.sfd.closure->access.poll;
+	FdState &state = fdState( fd );
+
+	if ( poll.getEpoll() != epollFd ) {		// not registered in this cluster's epoll set ?
+	    switch ( registerFD( fd ) ) {
+	      case 0:					// new registration
+		state.ready = 0;			// edges belong to a previous descriptor with the same number
+		// FALL THROUGH
+	      case EEXIST:
+		poll.setEpoll( epollFd );
+		break;
+	      default:					// cannot be polled (e.g., regular file) so always ready
+		state.ready = uCluster::ReadSelect | uCluster::WriteSelect | uCluster::ExceptSelect;
+	    } // switch
+	} // if
+
+	// An edge reported before this task registered is not reported again, so retry the operation.
+
+	int rwe = *node.smfd.sfd.uRWE & state.ready;
+	if ( ( rwe != 0 && attemptIO( node, state, rwe ) ) || node.timedout ) { // I/O performed or polling ?
+#ifdef __U_DEBUG_H__
+	    uDebugPrt( "(uNBIO &)%p.initSfd, node %p for fd %d completes without waiting, cnt:%d\n", this, &node, fd, node.nfds );
+#endif // __U_DEBUG_H__
+	    node.pending.V();				// do not block
+	    return false;
+	} // if
+
+#ifdef __U_DEBUG_H__
+	uDebugPrt( "(uNBIO &)%p.initSfd, adding node %p for fd %d\n", this, &node, fd );
+#endif // __U_DEBUG_H__
+
+	if ( timeoutEvent != NULL ) {
+	    timeoutEvent->add();
+	} // if
+	addWaiter( state, node );
+
+	uPid_t temp = IOPollerPid;			// race: IOPollerPid can change to -1 if poller wakes before wakeup
+	if ( temp != (uPid_t)-1 ) uThisCluster().wakeProcessor( temp );
+	pending += 1;
+	return checkPoller();
+    } // uNBIO::initSfd
+
+
+    bool uNBIO::initMfds( unsigned int nfds, NBIOnode &node, uEventNode *timeoutEvent ) {
+	registerMfds( nfds, node );
+
+	int cnt = pollMfds( node );
+	if ( cnt != 0 || node.timedout ) {		// I/O possible or polling ?
+	    node.nfds = cnt;				// set return value
+	    node.pending.V();				// do not block
+	    return false;
+	} // if
+
+	if ( nfds > mmaxFD ) {				// increase maxFD if necessary
+	    mmaxFD = nfds;
+	} // if
+
+	// set the appropriate fd bits in the master fd mask; mask pointers can be NULL => nothing in that mask
+	unsigned int tmask = howmany( nfds, NFDBITS );
+	if ( node.smfd.mfd.trfds != NULL ) {
+	    for ( unsigned int i = 0; i < tmask; i += 1 ) {
+		mrfds.fds_bits[i] |= node.smfd.mfd.trfds->fds_bits[i];
+	    } // for
+	} // if
+	if ( node.smfd.mfd.twfds != NULL ) {
+	    for ( unsigned int i = 0; i < tmask; i += 1 ) {
+		mwfds.fds_bits[i] |= node.smfd.mfd.twfds->fds_bits[i];
+	    } // for
+	} // if
+	if ( node.smfd.mfd.tefds != NULL ) {
+	    for ( unsigned int i = 0; i < tmask; i += 1 ) {
+		mefds.fds_bits[i] |= node.smfd.mfd.tefds->fds_bits[i];
+	    } // for
+	} // if
+
+#ifdef __U_DEBUG_H__
+	uDebugPrt( "(uNBIO &)%p.initMfds, adding node %p\n", this, &node );
+#endif // __U_DEBUG_H__
+
+	if ( timeoutEvent != NULL ) {
+	    timeoutEvent->add();
+	} // if
+
+	pendingIOMfds.addTail( &node );			// node is removed by IOPoller
+
+	uPid_t temp = IOPollerPid;			// race: IOPollerPid can change to -1 if poller wakes before wakeup
+	if ( temp != (uPid_t)-1 ) uThisCluster().wakeProcessor( temp );
+	pending += 1;
+	return checkPoller();
+    } // uNBIO::initMfds
+
+
+    uNBIO::uNBIO() {
+#ifdef __U_DEBUG_H__
+	uDebugPrt( "(uNBIO &)%p.uNBIO\n", this );
+#endif // __U_DEBUG_H__
+	epollFd = ::epoll_create1( EPOLL_CLOEXEC );
+	if ( epollFd == -1 ) {
+	    uAbort( "(uNBIO &)%p.uNBIO() : internal error, epoll_create1 failed, error(%d) %s.", this, errno, strerror( errno ) );
+	} // if
+	events = new epoll_event[EventsPerWait];
+	fdTable = new FdTable( FdChunks );		// descriptor chunks created on first use
+	FD_ZERO( &mrfds );				// clear the read set
+	FD_ZERO( &mwfds );				// clear the write set
+	FD_ZERO( &mefds );				// clear the exceptional set
+	mmaxFD = 0;					// all masks are clear
+	expired = 0;
+	pending = 0;
+	IOPoller = NULL;				// no poller task
+	IOPollerPid = (uPid_t)-1;			// IOPoller not blocked on a processor
+	timeoutOccurred = false;
+#if ! defined( __U_MULTI__ )
+	okToSelect = false;
+#endif // ! __U_MULTI__
+    } // uNBIO::uNBIO
+
+
+    uNBIO::~uNBIO() {
+	::close( epollFd );
+	delete [] events;
+	deleteFdTable();
+    } // uNBIO::~uNBIO
+#else
     bool uNBIO::initSfd( NBIOnode &node, uEventNode *timeoutEvent ) {
 	unsigned int fd = node.smfd.sfd.closure->access.fd; // optimization
 
@@ -874,6 +1675,8 @@ namespace UPP {
 	okToSelect = false;
 #endif // ! __U_MULTI__
     } // uNBIO::uNBIO
+#endif // __U_EPOLL__
+#endif // __U_PROCESSOR_POLLERS__
 
 
     int uNBIO::select( uIOClosure &closure, int &rwe, timeval *timeout ) {
@@ -885,10 +1688,16 @@ namespace UPP {
 	uDebugRelease();
 #endif // __U_DEBUG_H__
 
+#if defined( __U_EPOLL__ )
+	if ( closure.access.fd < 0 ) {
+	    uAbort( "Attempt to select on negative file descriptor %d.", closure.access.fd );
+	} // if
+#else
 	if ( closure.access.fd < 0 || FD_SETSIZE <= closure.access.fd ) {
 	    uAbort( "Attempt to select on file descriptor %d that exceeds range 0-%d.",
 		    closure.access.fd, FD_SETSIZE - 1 );
 	} // if
+#endif // __U_EPOLL__
 
 	NBIOnode node;
 	node.pending.P();
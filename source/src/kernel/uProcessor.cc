@@ -49,12 +49,26 @@
 #include <limits.h>					// PTHREAD_STACK_MIN
 
 #include <sys/syscall.h>				// SYS_exit
+#ifdef __U_EVENTFD_PARK__
+#include <sys/eventfd.h>				// eventfd
+#endif // __U_EVENTFD_PARK__
 
 
 using namespace UPP;
 
 
+#ifdef __U_MULTI__
+static inline unsigned long long int monotonicTime() {	// nanoseconds
+    timespec curr;
+    clock_gettime( CLOCK_MONOTONIC, &curr );
+    return (unsigned long long int)curr.tv_sec * 1000000000 + curr.tv_nsec;
+} // monotonicTime
+#endif // __U_MULTI__
+
+
+#if ! defined( __U_PROCESSOR_TIMERS__ )
 uEventList *uProcessor::events = NULL;
+#endif // ! __U_PROCESSOR_TIMERS__
 
 #if ! defined( __U_MULTI__ )
 uEventNode *uProcessor::contextEvent = NULL;
@@ -124,8 +138,8 @@ void uProcessorTask::main() {
 #ifdef __U_DEBUG_H__
 	    uDebugPrt( "(uProcessorTask &)%p.main, setPreemption( %d )\n", this, preemption );
 #endif // __U_DEBUG_H__
+	    processor.preemption = preemption;		// set first so a slice armed by another processor uses it
 	    processor.setContextSwitchEvent( preemption ); // use it to set the alarm for this processor
-	    processor.preemption = preemption;
 	} or _Accept( setCluster ) {
 #ifdef __U_DEBUG_H__
 	    uDebugPrt( "(uProcessorTask &)%p.main, setCluster %p %p\n", this, &processor.getCluster(), cluster );
@@ -150,6 +164,9 @@ void uProcessorTask::main() {
 #endif // __U_PROFILER__
 
 	    prevCluster.processorRemove( processor );
+#ifdef __U_TICKLESS__
+	    processor.disarmContextSwitchEvent();	// counted by the previous cluster, armed again before the next task
+#endif // __U_TICKLESS__
 	    processor.currCluster = cluster;
 	    THREAD_SETMEM( activeCluster, cluster );
 	    cluster->processorAdd( processor );
@@ -165,7 +182,7 @@ void uProcessorTask::main() {
 
 #if defined( __U_MULTI__ )
     processor.setContextSwitchEvent( 0 );		// clear the alarm on this processor
-    assert( ! processor.contextEvent->listed() );
+    assert( ! processor.contextEvent->pending() );
 
 #ifdef __U_PROFILER__
     // uniprocessor calls done in uProfilerBoot
@@ -441,6 +458,58 @@ void uProcessorKernel::schedule( uBaseSpinLock *lock, uBaseTask *task ) {
 } // uProcessorKernel::schedule
 
 
+// A direct handoff switches from the current task to a blocked task on the same cluster without passing through the
+// processor kernel and the cluster ready queue, halving the context switches for a rendezvous. The lock is released on
+// behalf of the current task by the task receiving the processor, once the current task's context is saved. Otherwise,
+// the handoff is a normal schedule. Bypassing the ready queue is only equivalent to making the task ready when the
+// queue is the FIFO default scheduler; a user scheduler may order the task by priority or place it elsewhere, and a
+// bound task must run on its processor.
+
+bool uProcessorKernel::handoffInternal( uBaseSpinLock *lock, uBaseTask *task ) {
+    uProcessor &processor = uThisProcessor();		// optimization
+    uBaseTask &currTask = uThisTask();
+
+    // Task must be unbound and execute on this cluster with the default scheduler, and the processor task must not be
+    // delayed by pending processor work.
+  if ( &task->bound != NULL || task->currCluster != processor.currCluster || ! processor.currCluster->fifoReadyQueue ) return false;
+  if ( ! processor.external.empty() || &currTask == processor.procTask ) return false;
+
+    assert( ! currTask.readyRef.listed() && ! task->readyRef.listed() );
+    assert( lock == NULL ? ! THREAD_GETMEM( disableIntSpin ) : THREAD_GETMEM( disableIntSpinCnt ) == 1 );
+
+    taskIsBlocking();
+    handoffLock = lock;
+
+#ifdef __U_STATISTICS__
+    uFetchAdd( UPP::Statistics::user_context_switches, 1 );
+    uFetchAdd( UPP::Statistics::handoff_switches, 1 );
+#endif // __U_STATISTICS__
+
+    task->currCoroutine->taskSw( *task );		// not resume because switching tasks
+    return true;
+} // uProcessorKernel::handoffInternal
+
+
+void uProcessorKernel::handoff( uBaseTask *task ) {
+    THREAD_GETMEM( This )->disableInterrupts();
+    if ( ! activeProcessorKernel->handoffInternal( NULL, task ) ) {
+	activeProcessorKernel->scheduleInternal( task );
+    } // if
+    THREAD_GETMEM( This )->enableInterrupts();
+    SCHEDULE_PROFILE()
+} // uProcessorKernel::handoff
+
+
+void uProcessorKernel::handoff( uBaseSpinLock *lock, uBaseTask *task ) {
+    THREAD_GETMEM( This )->disableInterrupts();
+    if ( ! activeProcessorKernel->handoffInternal( lock, task ) ) {
+	activeProcessorKernel->scheduleInternal( lock, task );
+    } // if
+    THREAD_GETMEM( This )->enableInterrupts();
+    SCHEDULE_PROFILE()
+} // uProcessorKernel::handoff
+
+
 void uProcessorKernel::onBehalfOfUser() {
     switch( kind ) {
       case 0:
@@ -577,7 +646,18 @@ void uProcessorKernel::main() {
     uThisProcessor().startTime = uRead_tsc();
 #endif
 
+#if defined( __U_PROCESSOR_TIMERS__ )
+    processor->events->createTimer();			// timer signals this kernel thread
+#endif // __U_PROCESSOR_TIMERS__
+
     uBaseTask *readyTask;
+#ifdef __U_MULTI__
+    unsigned long long int idleStart = 0;		// time spinning started, 0 => not spinning
+#endif // __U_MULTI__
+#if defined( __U_PROCESSOR_POLLERS__ )
+    unsigned int ioShard = uFetchAdd( UPP::uNBIO::shardCounter, 1 ); // home I/O shard, spreads polling across processors
+    unsigned int ioCycles = 0;				// scheduler passes since last I/O poll
+#endif // __U_PROCESSOR_POLLERS__
 
     for ( unsigned int spin = 0;; ) {
 #if ! defined( __U_MULTI__ )
@@ -690,6 +770,9 @@ void uProcessorKernel::main() {
 	if ( readyTask != NULL ) {			// ready queue not empty, schedule that task
 
 	    assert( ! readyTask->readyRef.listed() );
+#ifdef __U_TICKLESS__
+	    processor->resetContextSwitchEvent();	// time slice only if other tasks are waiting
+#endif // __U_TICKLESS__
 	    THREAD_SETMEM( activeTask, readyTask );
 
 #ifdef __U_DEBUG__
@@ -764,6 +847,19 @@ void uProcessorKernel::main() {
 	    onBehalfOfUser();				// execute code on scheduler stack on behalf of user
 	} // if
 
+#if defined( __U_IO_URING__ )
+	if ( processor->currCluster->uring != NULL ) {	// submit batched disk I/O and reap completions
+	    processor->currCluster->uring->poll( readyTask == NULL );
+	} // if
+#endif // __U_IO_URING__
+
+#if defined( __U_PROCESSOR_POLLERS__ )
+	if ( readyTask == NULL || ( ioCycles += 1 ) >= UPP::uNBIO::PollCycles ) { // idle or time to poll under load ?
+	    ioCycles = 0;
+	    processor->currCluster->NBIO->poll( ioShard, readyTask == NULL );
+	} // if
+#endif // __U_PROCESSOR_POLLERS__
+
 #ifdef __U_MULTI__
 	if ( ! THREAD_GETMEM( RFinprogress ) && THREAD_GETMEM( RFpending ) ) { // run roll forward ?
 	    uKernelModule::rollForward( true );
@@ -783,13 +879,33 @@ void uProcessorKernel::main() {
 	    } // for
 	} // if
 
-	if ( spin > processor->getSpin() ) {	// spin expired ?
-	    processor->currCluster->processorPause(); // put processor to sleep
+	// Spinning stops when the adaptive spin time is exceeded. Work found while spinning is a hit and the time spent
+	// waiting for it adjusts the budget, as does the time spent paused after a miss.
 
-	    if ( processor != uKernelModule::systemProcessor ) {
-		THREAD_SETMEM( RFpending, false );	// no pending roll forward
+	if ( spin == 0 ) {				// task executed ?
+	    if ( idleStart != 0 ) {			// found while spinning ?
+		processor->spinHit( monotonicTime() - idleStart );
+		idleStart = 0;
+	    } // if
+	} else {
+	    unsigned long long int now = monotonicTime();
+	    if ( idleStart == 0 ) idleStart = now;
+
+	    if ( processor->spinExpired( spin, now - idleStart ) ) { // spin expired ?
+		if ( processor->currCluster->processorPause() ) { // put processor to sleep, false => work found first
+		    processor->spinMiss( monotonicTime() - now );
+		} // if
+		idleStart = 0;
+
+#if ! defined( __U_PROCESSOR_TIMERS__ )
+		// Only the system processor has events; with per-processor timers, a pending roll forward processes
+		// this processor's events.
+		if ( processor != uKernelModule::systemProcessor ) {
+		    THREAD_SETMEM( RFpending, false );	// no pending roll forward
+		} // if
+#endif // ! __U_PROCESSOR_TIMERS__
+		spin = 0;				// set number of spins back to zero
 	    } // if
-	    spin = 0;					// set number of spins back to zero
 	} // if
 
 // 	if ( spin % 200 == 0 ) {
@@ -897,6 +1013,7 @@ void uProcessorKernel::main() {
 
 
 uProcessorKernel::uProcessorKernel() : uBaseCoroutine( PTHREAD_STACK_MIN > __U_DEFAULT_STACK_SIZE__ ? PTHREAD_STACK_MIN : __U_DEFAULT_STACK_SIZE__ ) {
+    handoffLock = NULL;
 } // uProcessorKernel::uProcessorKernel
 
 uProcessorKernel::~uProcessorKernel() {
@@ -931,10 +1048,16 @@ void uProcessor::createProcessor( uCluster &cluster, bool detached, int ms, int
     uProcessor::detached = detached;
     preemption = ms;
     uProcessor::spin = spin;
+#ifdef __U_TICKLESS__
+    sliceCluster = NULL;
+#endif // __U_TICKLESS__
 
 #ifdef __U_MULTI__
     contextSwitchHandler = new uCxtSwtchHndlr( *this );
     contextEvent = new uEventNode( *contextSwitchHandler );
+#if defined( __U_PROCESSOR_TIMERS__ )
+    events = uEventList::create();
+#endif // __U_PROCESSOR_TIMERS__
 
 #ifdef __U_PROFILER__
     profileProcessorSamplerInstance = NULL;
@@ -942,6 +1065,19 @@ void uProcessor::createProcessor( uCluster &cluster, bool detached, int ms, int
 #endif // __U_MULTI__
 
     terminated = false;
+#ifdef __U_MULTI__
+    spinBudget = 0;					// measured on first pause
+#endif // __U_MULTI__
+    readyQueueIndex = ~0u;				// no per-processor ready queue until scheduler assigns one
+    heapData = NULL;
+    uHeapControl::prepareProcessor( this );
+#ifdef __U_EVENTFD_PARK__
+    parked = false;
+    parkFD = ::eventfd( 0, EFD_NONBLOCK | EFD_CLOEXEC );
+    if ( parkFD == -1 ) {
+	uAbort( "(uProcessor &)%p.createProcessor() : internal error, eventfd failed, error(%d) %s.", this, errno, strerror( errno ) );
+    } // if
+#endif // __U_EVENTFD_PARK__
     currCluster->processorAdd( *this );
 
     uKernelModule::globalProcessorLock->acquire();	// add processor to global processor list.
@@ -1060,13 +1196,31 @@ uProcessor::~uProcessor() {
     uKernelModule::globalProcessorLock->release();
 
     currCluster->processorRemove( *this );
+#ifdef __U_TICKLESS__
+    disarmContextSwitchEvent();				// slice armed by another processor before the removal
+#endif // __U_TICKLESS__
+    uHeapControl::finishProcessor( this );		// no tasks execute on this processor
 #ifdef __U_MULTI__
+#ifdef __U_EVENTFD_PARK__
+    ::close( parkFD );
+#endif // __U_EVENTFD_PARK__
+#if defined( __U_PROCESSOR_TIMERS__ )
+    // Pending events, e.g., timeouts for tasks that executed on this processor, are taken over by the system
+    // processor.
+    if ( this != uKernelModule::systemProcessor ) {
+	events->transfer( *uKernelModule::systemProcessor->events, contextEvent );
+    } // if
+    events->recycle();					// never freed, a task removing an event may still refer to it
+    events = NULL;
+#endif // __U_PROCESSOR_TIMERS__
     delete contextEvent;
     delete contextSwitchHandler;
+#if ! defined( __U_PROCESSOR_TIMERS__ )
     if ( uKernelModule::systemTask == NULL ) {
 	delete events;
 	events = NULL;
     } // if
+#endif // ! __U_PROCESSOR_TIMERS__
 #endif // __U_MULTI__
 } // uProcessor::~uProcessor
 
@@ -1137,7 +1291,21 @@ void uProcessor::setContextSwitchEvent( uDuration duration ) {
     assert( THREAD_GETMEM( disableInt ) && THREAD_GETMEM( disableIntCnt ) == 1 );
     assert( duration >= 0 );
 
-    if ( ! contextEvent->listed() && duration != 0 ) { // first context switch event ?
+#ifdef __U_TICKLESS__
+    // A time slice is only needed when another task is waiting to execute on this processor's cluster; otherwise the
+    // timer keeps interrupting a processor that has nothing else to do. The event is armed by makeTaskReady or the
+    // kernel when competition appears and lapses when it expires without competition. Other processors may arm the
+    // event concurrently, so it is only added through arm.
+    if ( contextEvent->pending() && contextEvent->period != duration ) { // change ?
+	disarmContextSwitchEvent();
+    } // if
+    if ( duration != 0 && competition() ) {
+	events->armSlice( *this, activeProcessorKernel->kernelClock.getTime() + duration, duration );
+    } // if
+    return;
+#endif // __U_TICKLESS__
+
+    if ( ! contextEvent->pending() && duration != 0 ) { // first context switch event ?
 	contextEvent->alarm = activeProcessorKernel->kernelClock.getTime() + duration;
 	contextEvent->period = duration;
 	contextEvent->add();
@@ -1161,6 +1329,105 @@ void uProcessor::setContextSwitchEvent( int msecs ) {
 } // uProcessor::setContextSwitchEvent
 
 
+#ifdef __U_TICKLESS__
+bool uProcessor::competition() {
+    return ! currCluster->readyQueueEmpty() || ! external.empty();
+} // uProcessor::competition
+
+
+void uProcessor::resetContextSwitchEvent() {
+    // Called by the kernel before running a task: arm the time slice if tasks are waiting. An armed slice is not
+    // cancelled when the ready queue drains, so a processor alternating between one and two ready tasks does not reset
+    // its timer on every dispatch; the slice lapses when it expires without competition.
+
+  if ( preemption == 0 ) return;			// no preemption ?
+    if ( ! contextEvent->pending() && competition() ) { // racy read, rechecked by arm
+	uDuration duration( preemption / 1000L, preemption % 1000L * ( TIMEGRAN / 1000L ) );
+	events->armSlice( *this, activeProcessorKernel->kernelClock.getTime() + duration, duration );
+    } // if
+} // uProcessor::resetContextSwitchEvent
+
+
+void uProcessor::armContextSwitchEvent() {
+  if ( preemption == 0 ) return;			// no preemption ?
+  if ( &uThisProcessor() == this && &uThisTask() == procTask ) return; // in kernel ? => checked before running next task
+    uDuration duration( preemption / 1000L, preemption % 1000L * ( TIMEGRAN / 1000L ) );
+    events->armSlice( *this, activeProcessorKernel->kernelClock.getTime() + duration, duration );
+} // uProcessor::armContextSwitchEvent
+
+
+void uProcessor::disarmContextSwitchEvent() {
+    // Remove the time slice when preemption changes or stops, or the processor leaves its cluster. If tasks still wait
+    // on the cluster the slice was armed for, another processor there must time a slice.
+
+    uCluster *cluster = events->disarmSlice( *this );
+    if ( cluster != NULL && ! cluster->readyQueueEmpty() ) cluster->armSlice();
+} // uProcessor::disarmContextSwitchEvent
+#endif // __U_TICKLESS__
+
+
+#ifdef __U_MULTI__
+bool uProcessor::spinExpired( unsigned int spins, unsigned long long int spun ) {
+    // Until the first pause, the spin count decides, so the initial budget is the time the count takes on this
+    // machine. Afterwards only the budget applies, so it can extend spinning past the count as well as shorten it.
+
+  if ( spin == 0 ) return true;				// no spinning
+    if ( spinBudget == 0 ) {				// budget not measured ?
+      if ( spins <= spin ) return false;
+	spinBudget = spun < __U_DEFAULT_SPIN_MIN_NS__ ? __U_DEFAULT_SPIN_MIN_NS__ :
+	    spun < __U_DEFAULT_SPIN_MAX_NS__ ? spun : __U_DEFAULT_SPIN_MAX_NS__;
+	return true;
+    } // if
+    return spun > spinBudget;
+} // uProcessor::spinExpired
+
+
+void uProcessor::spinHit( unsigned long long int waited ) {
+    // Work arrived while spinning. If it arrived late in the spin, lengthen the budget so similar gaps are still
+    // covered.
+
+    if ( spinBudget != 0 && waited * 2 > spinBudget ) { // 0 => budget not measured, spin count still decides
+	spinBudget = waited * 2 < __U_DEFAULT_SPIN_MAX_NS__ ? waited * 2 : __U_DEFAULT_SPIN_MAX_NS__;
+    } // if
+#ifdef __U_STATISTICS__
+    uFetchAdd( UPP::Statistics::spin_hits, 1 );
+    spinStatistics();
+#endif // __U_STATISTICS__
+} // uProcessor::spinHit
+
+
+void uProcessor::spinMiss( unsigned long long int paused ) {
+    // The processor paused. A short pause means spinning slightly longer avoids the pause/wake round trip; a long pause
+    // means the spinning was wasted so decay the budget.
+
+    if ( paused < __U_DEFAULT_SPIN_MAX_NS__ ) {
+	if ( paused * 2 > spinBudget ) {
+	    spinBudget = paused * 2 < __U_DEFAULT_SPIN_MAX_NS__ ? paused * 2 : __U_DEFAULT_SPIN_MAX_NS__;
+	} // if
+    } else {
+	spinBudget -= spinBudget / 4;
+	if ( spinBudget < __U_DEFAULT_SPIN_MIN_NS__ ) spinBudget = __U_DEFAULT_SPIN_MIN_NS__;
+    } // if
+#ifdef __U_STATISTICS__
+    uFetchAdd( UPP::Statistics::spin_misses, 1 );
+    spinStatistics();
+#endif // __U_STATISTICS__
+} // uProcessor::spinMiss
+
+
+void uProcessor::spinStatistics() {
+#ifdef __U_STATISTICS__
+    // Each processor has its own budget, so record the average (over hits and misses) and maximum.
+
+    uFetchAdd( UPP::Statistics::spin_budget_total, spinBudget );
+    for ( unsigned int max = UPP::Statistics::spin_budget_max; spinBudget > max; max = UPP::Statistics::spin_budget_max ) {
+      if ( uCompareAssign( UPP::Statistics::spin_budget_max, max, spinBudget ) ) break;
+    } // for
+#endif // __U_STATISTICS__
+} // uProcessor::spinStatistics
+#endif // __U_MULTI__
+
+
 uCluster &uProcessor::setCluster( uCluster &cluster ) {
   if ( &cluster == &this->getCluster() ) return cluster; // trivial case
 
@@ -1226,6 +1493,7 @@ void uProcessor::setAffinity( const cpu_set_t &mask ) {
 #endif // __U_AFFINITY__
 	uAbort( "(uProcessor &)%p.setAffinity() : internal error, could not set processor affinity, error(%d) %s.", this, errno, strerror( errno ) );
     } // if
+    uHeapControl::affinityChanged();			// processor may have moved to another NUMA node
 } // uProcessor::setAffinity
 
 
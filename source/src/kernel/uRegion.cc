@@ -0,0 +1,149 @@
+//                              -*- Mode: C++ -*-
+//
+// uC++ Version 6.1.0, Copyright (C) agent 2026
+//
+// uRegion.cc -- bump-pointer allocation region
+//
+// Author           : agent
+// Created On       : Sun Oct 18 05:15:16 2026
+// Last Modified By : agent
+// Last Modified On : Sun Oct 18 06:36:16 2026
+// Update Count     : 3
+//
+// This  library is free  software; you  can redistribute  it and/or  modify it
+// under the terms of the GNU Lesser General Public License as published by the
+// Free Software  Foundation; either  version 2.1 of  the License, or  (at your
+// option) any later version.
+//
+// This library is distributed in the  hope that it will be useful, but WITHOUT
+// ANY  WARRANTY;  without even  the  implied  warranty  of MERCHANTABILITY  or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+// for more details.
+//
+// You should  have received a  copy of the  GNU Lesser General  Public License
+// along  with this library.
+//
+
+#define __U_KERNEL__
+#include <uC++.h>
+#include <uHeapLmmm.h>
+#include <uRegion.h>
+
+#include <cstdlib>					// malloc, free
+
+using namespace UPP;
+
+
+static uSpinLock bindLock;				// protects the lists of regions bound to tasks
+
+
+uRegion::uRegion() : next( NULL ), end( NULL ), chunks( NULL ), last( NULL ), large( NULL ), total( 0 ), owner( NULL ), link( NULL ) {
+} // uRegion::uRegion
+
+uRegion::uRegion( uBaseTask &task ) : next( NULL ), end( NULL ), chunks( NULL ), last( NULL ), large( NULL ), total( 0 ), owner( &task ), link( NULL ) {
+    bindLock.acquire();
+    link = (uRegion *)task.heapData;
+    task.heapData = this;
+    bindLock.release();
+} // uRegion::uRegion
+
+uRegion::~uRegion() {
+    unbind();
+    clear( false );
+} // uRegion::~uRegion
+
+
+void *uRegion::allocSlow( size_t size, size_t align ) {
+    // Blocks larger than a quarter of a chunk are allocated separately so a chunk is not mostly wasted.
+
+    if ( size + align > uHeapManager::RegionChunk / 4 ) {
+	Chunk *block = (Chunk *)::malloc( sizeof(Chunk) + size + align );
+      if ( block == NULL ) return NULL;
+	block->next = large;
+	large = block;
+	total += size;
+	return (void *)uCeiling( (unsigned long int)(block + 1), align );
+    } // if
+
+    Chunk *chunk = (Chunk *)uHeapManager::heapManagerInstance->regionChunk();
+  if ( chunk == NULL ) return NULL;
+    chunk->next = chunks;
+    chunks = chunk;
+    if ( last == NULL ) last = chunk;
+    end = (char *)chunk + uHeapManager::RegionChunk;
+    char *p = (char *)uCeiling( (unsigned long int)(chunk + 1), align );
+    next = p + size;
+    total += size;
+    return p;
+} // uRegion::allocSlow
+
+
+void uRegion::clear( bool keep ) {
+    // Return the chunks to the heap, except the current chunk if it is kept, and free the large blocks.
+
+    if ( chunks != NULL ) {
+	if ( ! keep ) {
+	    uHeapManager::heapManagerInstance->regionRelease( chunks, last );
+	    chunks = last = NULL;
+	    next = end = NULL;
+	} else {
+	    if ( chunks->next != NULL ) {
+		uHeapManager::heapManagerInstance->regionRelease( chunks->next, last );
+		chunks->next = NULL;
+		last = chunks;
+	    } // if
+	    next = (char *)(chunks + 1);
+	} // if
+    } // if
+    for ( Chunk *block = large; block != NULL; ) {
+	Chunk *n = block->next;
+	::free( block );
+	block = n;
+    } // for
+    large = NULL;
+    total = 0;
+} // uRegion::clear
+
+
+void uRegion::release() {
+    clear( true );
+} // uRegion::release
+
+
+void uRegion::unbind() {
+  if ( owner == NULL ) return;
+    bindLock.acquire();
+    for ( uRegion **rp = (uRegion **)&owner->heapData; *rp != NULL; rp = &(*rp)->link ) {
+	if ( *rp == this ) {
+	    *rp = link;
+	    break;
+	} // if
+    } // for
+    owner = NULL;
+    bindLock.release();
+} // uRegion::unbind
+
+
+void uRegion::finishTask( uBaseTask &task ) {
+    // Called by the task as its main routine ends, so no new region can be bound to it.
+
+    bindLock.acquire();
+    uRegion *regions = (uRegion *)task.heapData;
+    task.heapData = NULL;
+    for ( uRegion *r = regions; r != NULL; r = r->link ) {
+	r->owner = NULL;
+    } // for
+    bindLock.release();
+
+    for ( uRegion *r = regions; r != NULL; ) {
+	uRegion *n = r->link;
+	r->link = NULL;
+	r->clear( false );
+	r = n;
+    } // for
+} // uRegion::finishTask
+
+
+// Local Variables: //
+// compile-command: "make install" //
+// End: //
@@ -0,0 +1,142 @@
+//                              -*- Mode: C++ -*-
+//
+// uC++ Version 6.1.0, Copyright (C) agent 2026
+//
+// uRegion.h -- bump-pointer allocation region
+//
+// Author           : agent
+// Created On       : Sun Oct 18 05:15:16 2026
+// Last Modified By : agent
+// Last Modified On : Sun Oct 18 06:36:16 2026
+// Update Count     : 3
+//
+// This  library is free  software; you  can redistribute  it and/or  modify it
+// under the terms of the GNU Lesser General Public License as published by the
+// Free Software  Foundation; either  version 2.1 of  the License, or  (at your
+// option) any later version.
+//
+// This library is distributed in the  hope that it will be useful, but WITHOUT
+// ANY  WARRANTY;  without even  the  implied  warranty  of MERCHANTABILITY  or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+// for more details.
+//
+// You should  have received a  copy of the  GNU Lesser General  Public License
+// along  with this library.
+//
+
+
+#ifndef __U_REGION_H__
+#define __U_REGION_H__
+
+
+#include <uAlign.h>
+#include <cstddef>					// size_t, ptrdiff_t
+#include <new>						// bad_alloc
+
+
+// A region allocates by advancing a pointer through a chunk of storage. Objects in a region are not freed
+// individually; all of the region's storage is released at once by release or the destructor. Chunks come from the
+// heap's extension area and are recycled among regions, so allocation never acquires a free-list lock. A region bound
+// to a task has its storage released when the task's main routine ends. A region is used by one task at a time.
+
+class uRegion {
+    friend class UPP::uHeapControl;			// access: finishTask
+
+    struct Chunk {
+	Chunk *next;					// chunks of the region, most recent first
+    };
+
+    char *next, *end;					// unallocated storage in the current chunk
+    Chunk *chunks, *last;				// chunks from the heap
+    Chunk *large;					// separately allocated large blocks
+    size_t total;					// storage allocated in the region
+    uBaseTask *owner;					// task the region is bound to, NULL => unbound
+    uRegion *link;					// other regions bound to the task
+
+    void *allocSlow( size_t size, size_t align );
+    void clear( bool keep );
+    void unbind();
+    static void finishTask( uBaseTask &task );
+
+    uRegion( uRegion & );				// no copy
+    uRegion &operator=( uRegion & );			// no assignment
+  public:
+    uRegion();
+    uRegion( uBaseTask &task );				// storage released when task ends
+    ~uRegion();
+
+    void *alloc( size_t size, size_t align = uAlign() ) {
+	char *p = (char *)uCeiling( (unsigned long int)next, align );
+	if ( __builtin_expect( p < end && (size_t)(end - p) >= size, true ) ) {
+	    next = p + size;
+	    total += size;
+	    return p;
+	} // if
+	return allocSlow( size, align );
+    } // uRegion::alloc
+
+    void release();					// free all storage, keeping a chunk for reuse
+    size_t allocated() const { return total; }		// storage allocated since the last release
+}; // uRegion
+
+
+inline void *operator new( size_t size, uRegion &region ) {
+    void *p = region.alloc( size );
+    if ( p == NULL ) throw std::bad_alloc();
+    return p;
+} // operator new
+
+inline void *operator new[]( size_t size, uRegion &region ) {
+    void *p = region.alloc( size );
+    if ( p == NULL ) throw std::bad_alloc();
+    return p;
+} // operator new[]
+
+inline void operator delete( void *, uRegion & ) {}	// only called if a constructor throws
+inline void operator delete[]( void *, uRegion & ) {}
+
+
+// STL allocator for a region, e.g., std::vector< int, uRegionAllocator<int> > v( uRegionAllocator<int>( region ) ).
+// Deallocation does nothing; the storage is reclaimed when the region is released.
+
+template<typename T> class uRegionAllocator {
+    template<typename U> friend class uRegionAllocator;
+
+    uRegion *region;
+  public:
+    typedef T value_type;
+    typedef T *pointer;
+    typedef const T *const_pointer;
+    typedef T &reference;
+    typedef const T &const_reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    template<typename U> struct rebind { typedef uRegionAllocator<U> other; };
+
+    uRegionAllocator( uRegion &r ) : region( &r ) {}
+    template<typename U> uRegionAllocator( const uRegionAllocator<U> &other ) : region( other.region ) {}
+
+    T *allocate( size_t n, const void * = 0 ) {
+	void *p = region->alloc( n * sizeof(T), __alignof__(T) > uAlign() ? __alignof__(T) : uAlign() );
+	if ( p == NULL ) throw std::bad_alloc();
+	return (T *)p;
+    } // uRegionAllocator::allocate
+
+    void deallocate( T *, size_t ) {}
+    size_t max_size() const { return (size_t)-1 / sizeof(T); }
+    void construct( T *p, const T &value ) { new( (void *)p ) T( value ); }
+    void destroy( T *p ) { p->~T(); }
+    T *address( T &x ) const { return &x; }
+    const T *address( const T &x ) const { return &x; }
+
+    template<typename U> bool operator==( const uRegionAllocator<U> &other ) const { return region == other.region; }
+    template<typename U> bool operator!=( const uRegionAllocator<U> &other ) const { return region != other.region; }
+}; // uRegionAllocator
+
+
+#endif // __U_REGION_H__
+
+
+// Local Variables: //
+// compile-command: "make install" //
+// End: //
@@ -42,6 +42,8 @@
 
 namespace UPP {
     sigset_t uSigHandlerModule::block_mask;
+    struct sigaction uSigHandlerModule::heapProfilePrev;
+    bool uSigHandlerModule::heapProfileInstalled = false;
 
     void uSigHandlerModule::signal( int sig, void (*handler)(__U_SIGPARMS__), int flags ) { // name clash with uSignal statement
 	struct sigaction act;
@@ -123,6 +125,30 @@ namespace UPP {
     } // uSigHandlerModule::sigTermHandler
 
 
+    void uSigHandlerModule::sigHeapProfileHandler( __U_SIGTYPE__ ) {
+	// This routine handles a SIGUSR2 signal, which requests a dump of the heap profile (see M_HEAP_SAMPLE).  The
+	// profile cannot be written here because the signal may interrupt the holder of the profile lock, so the next
+	// allocation counted for sampling writes it.
+
+	uHeapManager::profileRequested = true;
+    } // uSigHandlerModule::sigHeapProfileHandler
+
+
+    void uSigHandlerModule::heapProfileSignal( bool on ) {
+	// SIGUSR2 belongs to the application except while the heap is sampled, so its disposition is saved when sampling
+	// starts and restored when sampling stops. Called with the heap extension lock held.
+
+      if ( on == heapProfileInstalled ) return;
+	if ( on ) {
+	    sigaction( SIGUSR2, NULL, &heapProfilePrev );
+	    signal( SIGUSR2, sigHeapProfileHandler, SA_SIGINFO | SA_RESTART );
+	} else {
+	    sigaction( SIGUSR2, &heapProfilePrev, NULL );
+	} // if
+	heapProfileInstalled = on;
+    } // uSigHandlerModule::heapProfileSignal
+
+
     static inline
 #if defined( __linux__ )
 
@@ -218,30 +244,34 @@ namespace UPP {
 
 	// Unsafe to perform these checks if in kernel or performing roll forward, because the thread specific variables
 	// used by uThis* routines are changing.
-#if defined( __U_DEBUG__ ) && defined( __U_MULTI__ )
+#if defined( __U_DEBUG__ ) && defined( __U_MULTI__ ) && ! defined( __U_PROCESSOR_TIMERS__ )
 	if ( sig == SIGALRM ) {				// only handle SIGALRM on system cluster
 	    assert( &uThisProcessor() == uKernelModule::systemProcessor );
 	    assert( &uThisCluster() == uKernelModule::systemCluster );
 	} // if
-#endif // __U_DEBUG__ && __U_MULTI__
+#endif // __U_DEBUG__ && __U_MULTI__ && ! __U_PROCESSOR_TIMERS__
 #if defined( __U_DEBUG__ )
 	uThisCoroutine().verify();			// good place to check for stack overflow
 #endif // __U_DEBUG__
 
-#if defined( __U_MULTI__ )
+#if defined( __U_MULTI__ ) && ! defined( __U_PROCESSOR_TIMERS__ )
 	if ( &uThisProcessor() != uKernelModule::systemProcessor ) {
 	    THREAD_SETMEM( RFinprogress, true );	// starting roll forward
 	} // if
-#endif // __U_MULTI__
+#endif // __U_MULTI__ && ! __U_PROCESSOR_TIMERS__
 
 	// Clear blocked SIGALRM/SIGUSR1 so more can arrive.
 	if ( sizeof( sigset_t ) != sizeof( cxt->uc_sigmask ) ) { // should disappear due to constant folding
 	    // uc_sigmask is incorrect size
 	    sigset_t new_mask;
 	    sigemptyset( &new_mask );
+#if defined( __U_PROCESSOR_TIMERS__ )
+	    sigaddset( &new_mask, SIGALRM );		// every processor has its own timer
+#else
 	    if ( &uThisProcessor() == uKernelModule::systemProcessor ) {
 		sigaddset( &new_mask, SIGALRM );
 	    } // if
+#endif // __U_PROCESSOR_TIMERS__
 	    sigaddset( &new_mask, SIGUSR1 );
 	    if ( sigprocmask( SIG_UNBLOCK, &new_mask, NULL ) == -1 ) {
 		uAbort( "internal error, sigprocmask" );
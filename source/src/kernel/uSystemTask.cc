@@ -45,6 +45,9 @@ void uSystemTask::main() {
 	    delete victim;
 	} or _Accept( pthreadDetachEnd ) {
 	    delete victim;
+	} or _Accept( trimIntervalChanged ) {		// guard and timeout reevaluated on next iteration
+	} or _When( UPP::uHeapControl::trimInterval() != 0 ) _Timeout( uDuration( 0, UPP::uHeapControl::trimInterval() * 1000000L ) ) {
+	    malloc_trim( 0 );				// background return of free storage to the operating system
 // #if __U_LOCALDEBUGGER_H__
 // 	} or _Timeout( uDuration( 1 ) ) {		// 1 second
 // #endif // __U_LOCALDEBUGGER_H__
@@ -82,6 +85,10 @@ void uSystemTask::reaper( uBaseTask &victim ) {
 } // uSystemTask::reaper
 
 
+void uSystemTask::trimIntervalChanged() {
+} // uSystemTask::trimIntervalChanged
+
+
 // Local Variables: //
 // compile-command: "make install" //
 // End: //
@@ -43,6 +43,7 @@ _Task uSystemTask {
     uSystemTask();
     ~uSystemTask();
     void reaper( uBaseTask &victim );
+    void trimIntervalChanged();				// reevaluate background trim period
 }; // uSystemTask
 
 
@@ -37,6 +37,14 @@ using std::min;
 #include <cstring>					// strerror
 #include <unistd.h>					// read, write, close, etc.
 #include <sys/uio.h>					// readv, writev
+#if defined( __linux__ )
+#include <fcntl.h>					// splice, tee, vmsplice
+#include <poll.h>
+#endif // __linux__
+
+
+// Recent durations of the system calls that may be offloaded to the blocking I/O cluster (see uBlockingIO).
+static UPP::uBlockingIO::Site readSite, spliceSite, openSite, fsyncSite, statSite, unlinkSite;
 
 
 //######################### uFileIO #########################
@@ -53,6 +61,11 @@ int uFileIO::read( char *buf, int len, uDuration *timeout ) {
 #ifdef __U_STATISTICS__
 	    uFetchAdd( UPP::Statistics::read_syscalls, 1 );
 #endif // __U_STATISTICS__
+#if defined( __U_IO_URING__ )
+	    UPP::uIOuring *ring = uring();
+	    if ( ring != NULL ) return ring->read( access.fd, buf, len );
+#endif // __U_IO_URING__
+	    UPP::uBlockingIO offload( readSite, access.poll.getStatus() == uPoll::NeverPoll ); // disk read blocks processor
 	    return ::read( access.fd, buf, len );
 	}
 	Read( uIOaccess &access, int &rlen ) : uIOClosure( access, rlen ) {}
@@ -126,7 +139,14 @@ int uFileIO::readv( const struct iovec *iov, int iovcnt, uDuration *timeout ) {
 	const struct iovec *iov;
 	int iovcnt;
 
-	int action() { return ::readv( access.fd, iov, iovcnt ); }
+	int action() {
+#if defined( __U_IO_URING__ )
+	    UPP::uIOuring *ring = uring();
+	    if ( ring != NULL ) return ring->readv( access.fd, iov, iovcnt );
+#endif // __U_IO_URING__
+	    UPP::uBlockingIO offload( readSite, access.poll.getStatus() == uPoll::NeverPoll ); // disk read blocks processor
+	    return ::readv( access.fd, iov, iovcnt );
+	}
 	Readv( uIOaccess &access, int &rlen, const struct iovec *iov, int iovcnt ) : uIOClosure( access, rlen ), iov( iov ), iovcnt( iovcnt ) {}
     } readvClosure( access, rlen, iov, iovcnt );
 
@@ -158,6 +178,10 @@ int uFileIO::write( const char *buf, int len, uDuration *timeout ) {
 #ifdef __U_STATISTICS__
 	    uFetchAdd( UPP::Statistics::write_syscalls, 1 );
 #endif // __U_STATISTICS__
+#if defined( __U_IO_URING__ )
+	    UPP::uIOuring *ring = uring();
+	    if ( ring != NULL ) return ring->write( access.fd, buf, len );
+#endif // __U_IO_URING__
 	    return ::write( access.fd, buf, len );
 	}
 	Write( uIOaccess &access, int &wlen ) : uIOClosure( access, wlen ) {}
@@ -202,7 +226,13 @@ int uFileIO::writev( const struct iovec *iov, int iovcnt, uDuration *timeout ) {
 	const struct iovec *iov;
 	int iovcnt;
 
-	int action() { return ::writev( access.fd, iov, iovcnt ); }
+	int action() {
+#if defined( __U_IO_URING__ )
+	    UPP::uIOuring *ring = uring();
+	    if ( ring != NULL ) return ring->writev( access.fd, iov, iovcnt );
+#endif // __U_IO_URING__
+	    return ::writev( access.fd, iov, iovcnt );
+	}
 	Writev( uIOaccess &access, int &wlen, const struct iovec *iov, int iovcnt ) : uIOClosure( access, wlen ), iov( iov ), iovcnt( iovcnt ) {}
     } writevClosure( access, wlen, iov, iovcnt );
 
@@ -225,6 +255,200 @@ int uFileIO::writev( const struct iovec *iov, int iovcnt, uDuration *timeout ) {
 } // uFileIO::writev
 
 
+#if defined( __linux__ )
+// splice and tee involve two descriptors, so a failed transfer does not say which one is not ready. Neither descriptor
+// can be waited on with the transfer as the closure action because the transfer may fail on the other descriptor after
+// the event is consumed. Instead, a closure that only checks readiness waits for whichever descriptor is not ready, and
+// the caller retries the transfer. Both descriptors can poll ready while the transfer keeps failing, e.g., a pipe with
+// room for less than a page, so after a few yields the task sleeps between retries until the destination is drained,
+// and the sleeps count against the timeout.
+
+enum { SpliceYields = 8,				// retries with both descriptors ready before sleeping
+       SpliceDelay = 1000000 };				// nanoseconds slept per retry after SpliceYields
+
+static bool spliceWait( uIOaccess &src, uIOaccess &dst, uDuration *timeout, unsigned int &retries ) {
+    struct Ready : public uIOClosure {
+	short events;
+
+	int action() {
+	    pollfd pfd = { access.fd, events, 0 };
+	    int ret = ::poll( &pfd, 1, 0 );		// zero timeout => check only
+	    if ( ret == 0 ) {
+		errno = U_EWOULDBLOCK;			// not ready => wait for an event
+		return -1;
+	    } // if
+	    return ret;					// ready, hangup or error => retry transfer, which reports the error
+	}
+	Ready( uIOaccess &access, int &ret, short events ) : uIOClosure( access, ret ), events( events ) {}
+    };
+
+    int ret;
+    Ready srcReady( src, ret, POLLIN );
+    srcReady.wrapper();
+    if ( ret == -1 ) {
+	retries = 0;
+	return srcReady.select( uCluster::ReadSelect, timeout );
+    } // if
+    Ready dstReady( dst, ret, POLLOUT );
+    dstReady.wrapper();
+    if ( ret == -1 ) {
+	retries = 0;
+	return dstReady.select( uCluster::WriteSelect, timeout );
+    } // if
+    retries += 1;					// both ready but transfer failed, e.g., pipe full of partial pages
+    if ( retries <= SpliceYields ) {
+	uThisTask().yield();
+	return true;
+    } // if
+  if ( timeout != NULL && uDuration( 0, (long int)( retries - SpliceYields ) * SpliceDelay ) > *timeout ) return false;
+    uThisTask().uSleep( uDuration( 0, SpliceDelay ) );
+    return true;
+} // spliceWait
+
+
+ssize_t uFileIO::splice( uFileIO &src, off_t *srcOff, off_t *dstOff, size_t len, unsigned int flags, uDuration *timeout ) {
+    int slen;
+
+    struct Splice : public uIOClosure {
+	uIOaccess &src;
+	off_t *srcOff, *dstOff;
+	size_t len;
+	unsigned int flags;
+
+	int action() {
+#ifdef __U_STATISTICS__
+	    uFetchAdd( UPP::Statistics::splice_syscalls, 1 );
+#endif // __U_STATISTICS__
+	    loff_t in, out;				// off_t may be narrower than loff_t
+	    if ( srcOff != NULL ) in = *srcOff;
+	    if ( dstOff != NULL ) out = *dstOff;
+	    if ( src.poll.getStatus() == uPoll::PollOnDemand ) src.poll.setPollFlag( src.fd ); // wrapper only handles this descriptor
+	    // disk transfer blocks processor
+	    UPP::uBlockingIO offload( spliceSite, src.poll.getStatus() == uPoll::NeverPoll || access.poll.getStatus() == uPoll::NeverPoll );
+	    int ret = ::splice( src.fd, srcOff != NULL ? &in : NULL, access.fd, dstOff != NULL ? &out : NULL, len, flags | SPLICE_F_NONBLOCK );
+	    if ( src.poll.getStatus() == uPoll::PollOnDemand ) src.poll.clearPollFlag( src.fd );
+	    if ( ret != -1 ) {
+		if ( srcOff != NULL ) *srcOff = in;
+		if ( dstOff != NULL ) *dstOff = out;
+	    } // if
+	    return ret;
+	}
+	Splice( uIOaccess &access, int &slen, uIOaccess &src, off_t *srcOff, off_t *dstOff, size_t len, unsigned int flags ) :
+	    uIOClosure( access, slen ), src( src ), srcOff( srcOff ), dstOff( dstOff ), len( len ), flags( flags ) {}
+    } spliceClosure( access, slen, src.access, srcOff, dstOff, len, flags );
+
+    unsigned int retries = 0;				// consecutive transfers failed with both descriptors ready
+    for ( ;; ) {
+	spliceClosure.wrapper();
+      if ( slen != -1 || spliceClosure.errno_ != U_EWOULDBLOCK ) break;
+#ifdef __U_STATISTICS__
+	uFetchAdd( UPP::Statistics::splice_eagain, 1 );
+#endif // __U_STATISTICS__
+	if ( ! spliceWait( src.access, access, timeout, retries ) ) {
+	    writeTimeout( NULL, len, timeout, "splice" );
+	} // if
+    } // for
+    if ( slen == -1 ) {
+#ifdef __U_STATISTICS__
+	uFetchAdd( UPP::Statistics::splice_errors, 1 );
+#endif // __U_STATISTICS__
+	writeFailure( spliceClosure.errno_, NULL, len, timeout, "splice" );
+    } // if
+
+#ifdef __U_STATISTICS__
+    uFetchAdd( UPP::Statistics::splice_bytes, slen );
+#endif // __U_STATISTICS__
+    return slen;
+} // uFileIO::splice
+
+
+ssize_t uFileIO::tee( uFileIO &src, size_t len, unsigned int flags, uDuration *timeout ) {
+    int tlen;
+
+    struct Tee : public uIOClosure {
+	uIOaccess &src;
+	size_t len;
+	unsigned int flags;
+
+	int action() {
+#ifdef __U_STATISTICS__
+	    uFetchAdd( UPP::Statistics::splice_syscalls, 1 );
+#endif // __U_STATISTICS__
+	    return ::tee( src.fd, access.fd, len, flags | SPLICE_F_NONBLOCK );
+	}
+	Tee( uIOaccess &access, int &tlen, uIOaccess &src, size_t len, unsigned int flags ) :
+	    uIOClosure( access, tlen ), src( src ), len( len ), flags( flags ) {}
+    } teeClosure( access, tlen, src.access, len, flags );
+
+    unsigned int retries = 0;				// consecutive transfers failed with both descriptors ready
+    for ( ;; ) {
+	teeClosure.wrapper();
+      if ( tlen != -1 || teeClosure.errno_ != U_EWOULDBLOCK ) break;
+#ifdef __U_STATISTICS__
+	uFetchAdd( UPP::Statistics::splice_eagain, 1 );
+#endif // __U_STATISTICS__
+	if ( ! spliceWait( src.access, access, timeout, retries ) ) {
+	    writeTimeout( NULL, len, timeout, "tee" );
+	} // if
+    } // for
+    if ( tlen == -1 ) {
+#ifdef __U_STATISTICS__
+	uFetchAdd( UPP::Statistics::splice_errors, 1 );
+#endif // __U_STATISTICS__
+	writeFailure( teeClosure.errno_, NULL, len, timeout, "tee" );
+    } // if
+
+#ifdef __U_STATISTICS__
+    uFetchAdd( UPP::Statistics::splice_bytes, tlen );
+#endif // __U_STATISTICS__
+    return tlen;
+} // uFileIO::tee
+
+
+ssize_t uFileIO::vmsplice( const struct iovec *iov, int iovcnt, unsigned int flags, uDuration *timeout ) {
+    int vlen;
+
+    struct Vmsplice : public uIOClosure {
+	const struct iovec *iov;
+	int iovcnt;
+	unsigned int flags;
+
+	int action() {
+#ifdef __U_STATISTICS__
+	    uFetchAdd( UPP::Statistics::splice_syscalls, 1 );
+#endif // __U_STATISTICS__
+	    return ::vmsplice( access.fd, iov, iovcnt, flags | SPLICE_F_NONBLOCK );
+	}
+	Vmsplice( uIOaccess &access, int &vlen, const struct iovec *iov, int iovcnt, unsigned int flags ) :
+	    uIOClosure( access, vlen ), iov( iov ), iovcnt( iovcnt ), flags( flags ) {}
+    } vmspliceClosure( access, vlen, iov, iovcnt, flags );
+
+    // Only this descriptor is involved, so the closure is performed when the pipe becomes writable.
+
+    vmspliceClosure.wrapper();
+    if ( vlen == -1 && vmspliceClosure.errno_ == U_EWOULDBLOCK ) {
+#ifdef __U_STATISTICS__
+	uFetchAdd( UPP::Statistics::splice_eagain, 1 );
+#endif // __U_STATISTICS__
+	if ( ! vmspliceClosure.select( uCluster::WriteSelect, timeout ) ) {
+	    writeTimeout( (const char *)iov, iovcnt, timeout, "vmsplice" );
+	} // if
+    } // if
+    if ( vlen == -1 ) {
+#ifdef __U_STATISTICS__
+	uFetchAdd( UPP::Statistics::splice_errors, 1 );
+#endif // __U_STATISTICS__
+	writeFailure( vmspliceClosure.errno_, (const char *)iov, iovcnt, timeout, "vmsplice" );
+    } // if
+
+#ifdef __U_STATISTICS__
+    uFetchAdd( UPP::Statistics::splice_bytes, vlen );
+#endif // __U_STATISTICS__
+    return vlen;
+} // uFileIO::vmsplice
+#endif // __linux__
+
+
 //######################### FileAccess #########################
 
 
@@ -332,10 +556,13 @@ void uFile::FileAccess::writeTimeout( const char *buf, const int len, const uDur
 
 
 void uFile::FileAccess::createAccess( int flags, int mode ) {
-    for ( ;; ) {
-	access.fd = ::open( file->name, flags, mode );
-      if ( access.fd != -1 || errno != EINTR ) break;	// timer interrupt ?
-    } // for
+    {
+	UPP::uBlockingIO offload( openSite );		// path lookup may block on disk
+	for ( ;; ) {
+	    access.fd = ::open( file->name, flags, mode );
+	  if ( access.fd != -1 || errno != EINTR ) break; // timer interrupt ?
+	} // for
+    }
     if ( access.fd == -1 ) {
         _Throw uFile::FileAccess::OpenFailure( *this, errno, flags, mode, "unable to access file" );
     } // if
@@ -401,12 +628,21 @@ off_t uFile::FileAccess::lseek( off_t offset, int whence ) {
 int uFile::FileAccess::fsync() {
     int retcode;
 
-    for ( ;; ) {
-	retcode = ::fsync( access.fd );
-      if ( retcode != -1 || errno != EINTR ) break;	// timer interrupt ?
-    } // for
+    struct Fsync : public uIOClosure {
+	int action() {
+#if defined( __U_IO_URING__ )
+	    UPP::uIOuring *ring = uring();
+	    if ( ring != NULL ) return ring->fsync( access.fd );
+#endif // __U_IO_URING__
+	    UPP::uBlockingIO offload( fsyncSite );	// waits for the device
+	    return ::fsync( access.fd );
+	}
+	Fsync( uIOaccess &access, int &retcode ) : uIOClosure( access, retcode ) {}
+    } fsyncClosure( access, retcode );
+
+    fsyncClosure.wrapper();
     if ( retcode == -1 ) {
-        _Throw uFile::FileAccess::SyncFailure( *this, errno, "could not fsync file" );
+        _Throw uFile::FileAccess::SyncFailure( *this, fsyncClosure.errno_, "could not fsync file" );
     } // if
     return retcode;
 } // uFile::FileAccess::fsync
@@ -445,6 +681,14 @@ void uFile::StatusFailure::defaultTerminate() const {
 } // uFile::StatusFailure::defaultTerminate
 
 
+uFile::UnlinkFailure::UnlinkFailure( const uFile &f, int errno_, const char *const msg ) : uFile::Failure( f, errno_, msg ) {}
+
+void uFile::UnlinkFailure::defaultTerminate() const {
+    uAbort( "(uFile &)%p.unlink(), %.256s \"%.256s\".\nError(%d) : %s.",
+	    &file(), message(), getName(), errNo(), strerror( errNo() ) );
+} // uFile::UnlinkFailure::defaultTerminate
+
+
 uFile::~uFile() {
     if ( accessCnt != 0 && ! std::uncaught_exception() ) {
 	TerminateFailure temp( *this, EINVAL, accessCnt, "terminating access with outstanding accessor(s)" );
@@ -474,17 +718,34 @@ const char *uFile::getName() const {
 
 void uFile::status( struct stat &buf ) {
     int retcode;
-
-    for ( ;; ) {
-	retcode = ::stat( name, &buf );
-      if ( retcode != -1 || errno != EINTR ) break;	// timer interrupt ?
-    } // for
+    {
+	UPP::uBlockingIO offload( statSite );		// path lookup may block on disk
+	for ( ;; ) {
+	    retcode = ::stat( name, &buf );
+	  if ( retcode != -1 || errno != EINTR ) break; // timer interrupt ?
+	} // for
+    }
     if ( retcode == -1 ) {
 	_Throw uFile::StatusFailure( *this, errno, buf, "could not obtain statistical information for file" );
     } // if
 } // uFile::status
 
 
+void uFile::unlink() {
+    int retcode;
+    {
+	UPP::uBlockingIO offload( unlinkSite );		// directory update may block on disk
+	for ( ;; ) {
+	    retcode = ::unlink( name );
+	  if ( retcode != -1 || errno != EINTR ) break; // timer interrupt ?
+	} // for
+    }
+    if ( retcode == -1 ) {
+	_Throw uFile::UnlinkFailure( *this, errno, "could not unlink file" );
+    } // if
+} // uFile::unlink
+
+
 //######################### End #########################
 
 
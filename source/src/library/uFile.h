@@ -63,6 +63,14 @@ class uFileIO {						// monitor
     int readv( const struct iovec *iov, int iovcnt, uDuration *timeout = NULL );
     _Mutex int write( const char *buf, int len, uDuration *timeout = NULL );
     int writev( const struct iovec *iov, int iovcnt, uDuration *timeout = NULL );
+#if defined( __linux__ )
+    // Zero-copy transfers into this descriptor, where the source or this descriptor must be a pipe. Offsets apply only
+    // to a descriptor that is not a pipe or socket. For tee, both descriptors are pipes; for vmsplice, this descriptor
+    // is the write end of a pipe.
+    ssize_t splice( uFileIO &src, off_t *srcOff, off_t *dstOff, size_t len, unsigned int flags = 0, uDuration *timeout = NULL );
+    ssize_t tee( uFileIO &src, size_t len, unsigned int flags = 0, uDuration *timeout = NULL );
+    ssize_t vmsplice( const struct iovec *iov, int iovcnt, unsigned int flags = 0, uDuration *timeout = NULL );
+#endif // __linux__
 
     int fd() {
 	return access.fd;
@@ -113,6 +121,12 @@ class uFile {
 	virtual void defaultTerminate() const;
     }; // uFile::StatusFailure
 
+    _Event UnlinkFailure : public Failure {
+      public:
+	UnlinkFailure( const uFile &f, int errno_, const char *const msg );
+	virtual void defaultTerminate() const;
+    }; // uFile::UnlinkFailure
+
     class FileAccess : public uFileIO {		// monitor
 	template< typename char_t, typename traits > friend class std::basic_filebuf; // access: constructor
 	friend class uSocketIO;				// access: access
@@ -238,6 +252,7 @@ class uFile {
     const char *setName( char *name );
     const char *getName() const;
     void status( struct stat &buf );
+    void unlink();					// remove the name from the file system
 }; // uFile
 
 
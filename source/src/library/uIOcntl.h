@@ -75,6 +75,12 @@ struct uIOClosure {
 	return true;
     } // uIOClosure::select
 
+#if defined( __U_IO_URING__ )
+    UPP::uIOuring *uring() {				// cluster io_uring for descriptors that cannot be polled, or 0
+	return access.poll.getStatus() == uPoll::NeverPoll ? uThisCluster().ioUring() : NULL;
+    } // uIOClosure::uring
+#endif // __U_IO_URING__
+
     virtual int action() = 0;
 }; // uIOClosure
 
@@ -51,7 +51,22 @@ class uPoll {
     enum PollStatus { NeverPoll, PollOnDemand, AlwaysPoll };
   private:
     PollStatus uStatus;
+#if defined( __U_EPOLL__ )
+    int epollFd;					// epoll set holding the descriptor, -1 => not registered
+#endif // __U_EPOLL__
   public:
+#if defined( __U_EPOLL__ )
+    uPoll() : epollFd( -1 ) {}
+
+    int getEpoll() {
+	return epollFd;
+    } // uPoll::getEpoll
+
+    void setEpoll( int fd ) {
+	epollFd = fd;
+    } // uPoll::setEpoll
+
+#endif // __U_EPOLL__
     PollStatus getStatus() {
 	return uStatus;
     } // uPoll::getStatus
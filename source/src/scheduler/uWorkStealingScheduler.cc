@@ -0,0 +1,237 @@
+//                              -*- Mode: C++ -*-
+//
+// uC++ Version 6.1.0, Copyright (C) agent 2026
+//
+// uWorkStealingScheduler.cc -- per-processor ready queues with work stealing
+//
+// Author           : agent
+// Created On       : Sun Oct 18 04:42:08 2026
+// Last Modified By : agent
+// Last Modified On : Sun Oct 18 06:36:11 2026
+// Update Count     : 3
+//
+// This  library is free  software; you  can redistribute  it and/or  modify it
+// under the terms of the GNU Lesser General Public License as published by the
+// Free Software  Foundation; either  version 2.1 of  the License, or  (at your
+// option) any later version.
+//
+// This library is distributed in the  hope that it will be useful, but WITHOUT
+// ANY  WARRANTY;  without even  the  implied  warranty  of MERCHANTABILITY  or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+// for more details.
+//
+// You should  have received a  copy of the  GNU Lesser General  Public License
+// along  with this library.
+//
+
+#define __U_KERNEL__
+#include <uC++.h>
+#include <uWorkStealingScheduler.h>
+#include <new>						// placement new
+
+//#include <uDebug.h>
+
+
+uWorkStealingScheduler::uWorkStealingScheduler( unsigned int capacity ) : capacity( capacity ), used( 0 ) {
+    queues = (Local *)::memalign( sizeof(Local), sizeof(Local) * (capacity + 1) ); // extra queue for overflow
+    if ( queues == NULL ) {
+	uAbort( "(uWorkStealingScheduler &)%p.uWorkStealingScheduler : internal error, cannot allocate %u ready queues.", this, capacity + 1 );
+    } // if
+    for ( unsigned int i = 0; i <= capacity; i += 1 ) {
+	new( &queues[i] ) Local;
+	queues[i].owner = NULL;
+	queues[i].seed = i + 1;
+    } // for
+} // uWorkStealingScheduler::uWorkStealingScheduler
+
+
+uWorkStealingScheduler::~uWorkStealingScheduler() {
+    for ( unsigned int i = 0; i <= capacity; i += 1 ) {
+	queues[i].~Local();
+    } // for
+    ::free( queues );
+} // uWorkStealingScheduler::~uWorkStealingScheduler
+
+
+uWorkStealingScheduler::Local *uWorkStealingScheduler::local( uProcessor &processor ) {
+    // Unlocked check: the owner must be rechecked after acquiring the queue lock as the processor may have left the
+    // cluster.
+    unsigned int index = getReadyQueueIndex( processor );
+    if ( index < used && queues[index].owner == &processor ) return &queues[index];
+    return NULL;
+} // uWorkStealingScheduler::local
+
+
+uBaseTaskDL *uWorkStealingScheduler::steal( uProcessor &processor, unsigned int start ) {
+    uBaseTaskDL *node;
+
+    Local &shared = overflow();
+    if ( ! shared.list.empty() ) {			// unlocked check
+	shared.lock.acquire();
+	node = shared.list.dropHead();
+	shared.lock.release();
+	if ( node != NULL ) return node;
+    } // if
+
+    // Visit each queue once starting at a random victim. A victim whose lock is held is skipped rather than waited
+    // for, as the owner is likely adding or removing work; the kernel spin loop calls again.
+
+    unsigned int n = used;
+    for ( unsigned int i = 0; i < n; i += 1 ) {
+	Local &victim = queues[(start + i) % n];
+      if ( victim.owner == &processor || victim.list.empty() ) continue; // unlocked check
+      if ( ! victim.lock.tryacquire() ) continue;
+	node = victim.list.dropHead();
+	victim.lock.release();
+	if ( node != NULL ) return node;
+    } // for
+    return NULL;
+} // uWorkStealingScheduler::steal
+
+
+bool uWorkStealingScheduler::empty() const {
+    // Unlocked hint, which is sufficient because the processor's own queue is checked by the processor itself and
+    // other processors are awake.
+
+    if ( ! queues[capacity].list.empty() ) return false;
+    unsigned int n = used;
+    for ( unsigned int i = 0; i < n; i += 1 ) {
+	if ( ! queues[i].list.empty() ) return false;
+    } // for
+    return true;
+} // uWorkStealingScheduler::empty
+
+
+void uWorkStealingScheduler::add( uBaseTaskDL *node ) {
+    uProcessor &processor = uThisProcessor();
+    Local *q = local( processor );
+    if ( q != NULL ) {
+	q->lock.acquire();
+	if ( q->owner == &processor ) {			// still own queue ?
+	    q->list.addTail( node );
+	    q->lock.release();
+	    return;
+	} // if
+	q->lock.release();
+    } // if
+
+    Local &shared = overflow();				// processor not on cluster or no queue available
+    shared.lock.acquire();
+    shared.list.addTail( node );
+    shared.lock.release();
+} // uWorkStealingScheduler::add
+
+
+uBaseTaskDL *uWorkStealingScheduler::drop() {
+    uProcessor &processor = uThisProcessor();
+    unsigned int start = 0;
+    Local *q = local( processor );
+    if ( q != NULL ) {
+	if ( ! q->list.empty() ) {			// unlocked check
+	    uBaseTaskDL *node = NULL;
+	    q->lock.acquire();
+	    if ( q->owner == &processor ) node = q->list.dropHead();
+	    q->lock.release();
+	    if ( node != NULL ) return node;
+	} // if
+	q->seed ^= q->seed << 13;			// xorshift
+	q->seed ^= q->seed >> 17;
+	q->seed ^= q->seed << 5;
+	start = q->seed;
+    } // if
+    return steal( processor, start );
+} // uWorkStealingScheduler::drop
+
+
+void uWorkStealingScheduler::remove( uBaseTaskDL *node ) {
+    uBaseTaskDL *p;
+
+    for ( unsigned int i = 0; i <= capacity; i += 1 ) {
+	Local &q = queues[i];
+	q.lock.acquire();
+	for ( uSeqIter<uBaseTaskDL> iter( q.list ); iter >> p; ) {
+	    if ( p == node ) {
+		q.list.remove( node );
+		q.lock.release();
+		return;
+	    } // if
+	} // for
+	q.lock.release();
+    } // for
+} // uWorkStealingScheduler::remove
+
+
+void uWorkStealingScheduler::transfer( uBaseTaskSeq &from, unsigned int ) {
+    uProcessor &processor = uThisProcessor();
+    Local *q = local( processor );
+    if ( q != NULL ) {
+	q->lock.acquire();
+	if ( q->owner == &processor ) {			// still own queue ?
+	    q->list.transfer( from );
+	    q->lock.release();
+	    return;
+	} // if
+	q->lock.release();
+    } // if
+
+    Local &shared = overflow();
+    shared.lock.acquire();
+    shared.list.transfer( from );
+    shared.lock.release();
+} // uWorkStealingScheduler::transfer
+
+
+bool uWorkStealingScheduler::checkPriority( uBaseTaskDL &, uBaseTaskDL & ) { return false; }
+
+void uWorkStealingScheduler::resetPriority( uBaseTaskDL &, uBaseTaskDL & ) {}
+
+void uWorkStealingScheduler::addInitialize( uBaseTaskSeq & ) {};
+
+void uWorkStealingScheduler::removeInitialize( uBaseTaskSeq & ) {};
+
+void uWorkStealingScheduler::rescheduleTask( uBaseTaskDL *, uBaseTaskSeq & ) {};
+
+
+bool uWorkStealingScheduler::internalLocking() const {
+    return true;
+} // uWorkStealingScheduler::internalLocking
+
+
+void uWorkStealingScheduler::processorAdd( uProcessor &processor ) {
+    queuesLock.acquire();
+    unsigned int i;
+    for ( i = 0; i < capacity && queues[i].owner != NULL; i += 1 ); // find unused queue
+    if ( i < capacity ) {
+	queues[i].lock.acquire();
+	queues[i].owner = &processor;
+	queues[i].lock.release();
+	if ( i + 1 > used ) used = i + 1;
+    } // if
+    setReadyQueueIndex( processor, i );			// i == capacity => overflow queue
+    queuesLock.release();
+} // uWorkStealingScheduler::processorAdd
+
+
+void uWorkStealingScheduler::processorRemove( uProcessor &processor ) {
+    queuesLock.acquire();
+    unsigned int i = getReadyQueueIndex( processor );
+    if ( i < capacity && queues[i].owner == &processor ) {
+	Local &q = queues[i];
+	q.lock.acquire();
+	q.owner = NULL;
+	if ( ! q.list.empty() ) {			// move remaining tasks where other processors can find them
+	    Local &shared = overflow();
+	    shared.lock.acquire();
+	    shared.list.transfer( q.list );
+	    shared.lock.release();
+	} // if
+	q.lock.release();
+    } // if
+    setReadyQueueIndex( processor, ~0u );
+    queuesLock.release();
+} // uWorkStealingScheduler::processorRemove
+
+
+// Local Variables: //
+// compile-command: "make install" //
+// End: //
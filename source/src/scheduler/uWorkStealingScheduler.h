@@ -0,0 +1,88 @@
+//                              -*- Mode: C++ -*-
+//
+// uC++ Version 6.1.0, Copyright (C) agent 2026
+//
+// uWorkStealingScheduler.h -- per-processor ready queues with work stealing
+//
+// Author           : agent
+// Created On       : Sun Oct 18 04:42:08 2026
+// Last Modified By : agent
+// Last Modified On : Sun Oct 18 06:36:11 2026
+// Update Count     : 3
+//
+// This  library is free  software; you  can redistribute  it and/or  modify it
+// under the terms of the GNU Lesser General Public License as published by the
+// Free Software  Foundation; either  version 2.1 of  the License, or  (at your
+// option) any later version.
+//
+// This library is distributed in the  hope that it will be useful, but WITHOUT
+// ANY  WARRANTY;  without even  the  implied  warranty  of MERCHANTABILITY  or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+// for more details.
+//
+// You should  have received a  copy of the  GNU Lesser General  Public License
+// along  with this library.
+//
+
+
+#ifndef __U_WORKSTEALINGSCHEDULER_H__
+#define __U_WORKSTEALINGSCHEDULER_H__
+
+#pragma __U_NOT_USER_CODE__
+
+#include <uC++.h>
+
+// Each processor on the cluster has its own FIFO ready queue, so adding and removing tasks does not contend on a
+// cluster-wide lock. A processor whose queue is empty steals from the head of the queue of a randomly chosen
+// victim. Tasks made ready by processors not on the cluster, or by processors beyond the queue capacity, are placed on
+// a shared overflow queue.
+//
+//    uWorkStealingScheduler rq( 8 );
+//    uCluster clus( rq );
+
+class uWorkStealingScheduler : public uBaseSchedule<uBaseTaskDL> {
+    struct Local {
+	uSpinLock lock;					// protect list and owner
+	uBaseTaskSeq list;				// tasks awaiting execution
+	uProcessor *owner;				// processor using this queue, NULL => unused
+	unsigned int seed;				// victim selection, only used by owner
+    } __attribute__(( aligned (128) ));			// prevent false sharing among queues
+
+    uSpinLock queuesLock;				// protect queue assignment
+    unsigned int capacity;				// number of per-processor queues
+    volatile unsigned int used;				// highest queue index assigned + 1
+    Local *queues;					// capacity per-processor queues + overflow queue
+
+    uWorkStealingScheduler( uWorkStealingScheduler & );	// no copy
+    uWorkStealingScheduler &operator=( uWorkStealingScheduler & ); // no assignment
+
+    Local &overflow() { return queues[capacity]; }
+    Local *local( uProcessor &processor );
+    uBaseTaskDL *steal( uProcessor &processor, unsigned int start );
+  public:
+    uWorkStealingScheduler( unsigned int capacity = 32 );
+    ~uWorkStealingScheduler();
+
+    bool empty() const;
+    void add( uBaseTaskDL *node );
+    uBaseTaskDL *drop();
+    void remove( uBaseTaskDL *node );
+    void transfer( uBaseTaskSeq &from, unsigned int n = 0 );
+    bool checkPriority( uBaseTaskDL &owner, uBaseTaskDL &calling );
+    void resetPriority( uBaseTaskDL &owner, uBaseTaskDL &calling );
+    void addInitialize( uBaseTaskSeq &taskList );
+    void removeInitialize( uBaseTaskSeq &taskList );
+    void rescheduleTask( uBaseTaskDL *taskNode, uBaseTaskSeq &taskList );
+
+    bool internalLocking() const;
+    void processorAdd( uProcessor &processor );
+    void processorRemove( uProcessor &processor );
+}; // uWorkStealingScheduler
+
+#pragma __U_USER_CODE__
+
+#endif //  __U_WORKSTEALINGSCHEDULER_H__
+
+// Local Variables: //
+// compile-command: "make install" //
+// End: //
@@ -4246,7 +4246,12 @@ static bool body( table_t *search, token_t *function, attribute_t &attribute, sy
 	    if ( user &&				// user code ? (see #pragma __U_USER_CODE__)
 		 // Since these routines are used at boot time, they cannot be annotated.
 		 strcmp( function->hash->text, "uDefaultHeapExpansion" ) != 0 &&
+		 strcmp( function->hash->text, "uDefaultHeapHugePages" ) != 0 &&
+		 strcmp( function->hash->text, "uDefaultHeapSample" ) != 0 &&
+		 strcmp( function->hash->text, "uDefaultHeapBuckets" ) != 0 &&
 		 strcmp( function->hash->text, "uDefaultStackSize" ) != 0 &&
+		 strcmp( function->hash->text, "uDefaultStackCache" ) != 0 &&
+		 strcmp( function->hash->text, "uDefaultStackMmap" ) != 0 &&
 		 strcmp( function->hash->text, "uMainStackSize" ) != 0 &&
 		 strcmp( function->hash->text, "uDefaultSpin" ) != 0 &&
 		 strcmp( function->hash->text, "uDefaultPreemption" ) != 0
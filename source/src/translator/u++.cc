@@ -576,6 +576,10 @@ int main( int argc, char *argv[] ) {
 	if ( multi ) {
 	    libs[nlibs] = "-lpthread";
 	    nlibs += 1;
+	    if ( tos == "linux" ) {
+		libs[nlibs] = "-lrt";			// timer_create
+		nlibs += 1;
+	    } // if
 	} // if
     } // if
 